@@ -5,34 +5,64 @@
 #include <LoRa.h>
 #include <U8g2lib.h>
 #include <Format.h>
+#include <LowPowerRx.h>
+#include <Capture.h>
+#include <Frame.h>
+#include <RadioLink.h>
+#include <RemoteState.h>
+#include <Auth.h>
+#include <RadioProfile.h>
+#include <TxScheduler.h>
+#include <EEPROMex.h>
+#include <Fixed.h>
+#include <TrendBuffer.h>
 
 const uint8_t R1 = A0;
 const uint8_t R2 = A1;
 const uint8_t ERR_TEMP = 1;
+// Первые замеры удаленного блока после включения, до полной медианы: показываются, в тренд не идут.
+const uint8_t ERR_WARMUP = 2;
 
 const uint8_t OLED_CS = 8;
 const uint8_t OLED_DC = 6;
 const uint8_t OLED_RESET = 5;
 
+// Допустимые уставка температуры и пороги реле удаленного блока.
+constexpr Centi TEMP_MIN = Centi::fromInt(-20);
+constexpr Centi TEMP_MAX = Centi::fromInt(40);
+constexpr Centi THRESHOLD_MIN = Centi::fromFraction(1, 10);
+constexpr Centi THRESHOLD_MAX = Centi::fromInt(10);
+
+// Запись принятых кадров в Serial в формате Capture для отладки.
+const bool CAPTURE = false;
+const long CAPTURE_BAUD = 115200;
+
+const uint8_t NODE_ID = 'H';
+const uint8_t PEER_ID = 'R';
+
+// Аутентификация кадров включается общим для обоих блоков ключом в include/AuthKey.h
+// (см. libraries/Auth/AuthKey.h.example).
+#if __has_include(<AuthKey.h>)
+#include <AuthKey.h>
+const bool AUTH = true;
+#else
+const uint8_t AUTH_KEY[16] = {};
+const bool AUTH = false;
+#endif
+
 class Controller : public HandlerInterface {
 
 protected:
-    float snr = 0;
-
-    union Int {
-        int i = 0;
-        uint8_t b[sizeof(int)];
-    };
+    RadioLink radio{RADIO, NODE_ID, PEER_ID};
 
-    Int angle;
+    // Принятые пакеты, не прошедшие проверку формата или подписи.
+    unsigned long dropped = 0;
 
-    union Float {
-        float f = 0;
-        uint8_t b[sizeof(float)];
-    };
-
-    Float currentTemp;
-    Float currentHum;
+    static const uint8_t CFG_ANGLE = 1;
+    static const uint8_t CFG_TEMP = 2;
+    static const uint8_t CFG_R1 = 4;
+    static const uint8_t CFG_R2 = 8;
+    static const uint8_t CFG_ALL = CFG_ANGLE | CFG_TEMP | CFG_R1 | CFG_R2;
 
     virtual bool relayIsOn(uint8_t pin)= 0;
 
@@ -43,11 +73,7 @@ public:
 
     Controller(uint8_t cs, uint8_t dc, uint8_t reset)
     {
-        LoRa.begin(433E6);
-        LoRa.setTxPower(16);
-        LoRa.setSpreadingFactor(8);
-        LoRa.enableCrc();
-        LoRa.receive();
+        radio.begin();
     }
 
     virtual void render() = 0;
@@ -56,30 +82,265 @@ public:
 class HomeController : public Controller {
 
     const uint16_t NO_SIGNAL_TIMEOUT = 60000;
+    // Повтор запроса настроек после перезагрузки, пока не принят ни один кадр. Без него
+    // потерянный запрос оставил бы прием без синхронизации до следующего блока счетчика
+    // удаленного блока (256 кадров, больше 40 минут). Интервал удваивается после каждого
+    // запроса без ответа: при выключенном удаленном блоке запросы (в режиме CAD по 0.6 с
+    // в эфире) иначе занимали бы эфир бесконечно.
+    const uint16_t SYNC_RETRY = 15000;
+    const unsigned long SYNC_RETRY_MAX = 240000;
 
 protected:
     U8G2_SH1106_128X64_NONAME_F_4W_HW_SPI *oled;
 
-    uint8_t r1IsOn = 0;
-    uint8_t r2IsOn = 0;
+    uint8_t displayState = STATE_DISPLAY;
+    uint8_t editField = EDIT_ANGLE;
+    bool configLoaded = false;
+    bool configRejected = false;
+    Frame::Config config{};
+
+    // Последнее состояние удаленного блока из телеметрии.
+    RemoteState remote;
 
-    uint8_t errCode = 0;
+    TrendBuffer trend;
+    uint8_t trendPage = TREND_TEMP;
 
     unsigned long lastReceive = 0;
     unsigned long noSignal = 0;
 
+    unsigned long syncRequestedAt = 0;
+    unsigned long syncRetry = SYNC_RETRY;
+
+    void drawEditValue(const char *label, const char *value) {
+        oled->drawUTF8(2, 32, label);
+        oled->setFont(u8g2_font_logisoso16_tf);
+        oled->drawUTF8(30, 56, value);
+        oled->setFont(u8g2_font_mercutio_basic_nbp_t_all);
+    }
+
+    void renderEdit() {
+        oled->drawUTF8(35, 12, "настройка");
+
+        if (!configLoaded || editField == EDIT_SAVING) {
+            oled->drawUTF8(30, 40, "загрузка...");
+            return;
+        }
+        if (configRejected) {
+            oled->drawUTF8(80, 32, "ошибка");
+        }
+
+        char value[12]{};
+        if (editField == EDIT_ANGLE) {
+            sprintf(value, "%2d", config.angle / 2);
+            strcat(value, "%");
+            drawEditValue("вент.", value);
+        } else if (editField == EDIT_TEMP) {
+            Format::temperature(value, Centi::fromRaw(config.requiredTemp), true);
+            drawEditValue("темп.", value);
+        } else if (editField == EDIT_R1) {
+            Format::temperature(value, Centi::fromRaw(config.r1Threshold), true);
+            drawEditValue("реле 1", value);
+        } else if (editField == EDIT_R2) {
+            Format::temperature(value, Centi::fromRaw(config.r2Threshold), true);
+            drawEditValue("реле 2", value);
+        }
+    }
+
+    // Уставки в кадре передаются сотыми долями, шаг редактора 0.1°.
+    static int16_t stepValue(int16_t raw, int diff, Centi min, Centi max) {
+        Centi value = Centi::fromRaw(raw) + Centi::fromFraction(diff, 10);
+        return constrain(value, min, max).toRaw();
+    }
+
+    void editValue(int diff) {
+        if (!configLoaded || editField == EDIT_SAVING) {
+            return;
+        }
+        if (editField == EDIT_ANGLE) {
+            config.angle = constrain(config.angle + diff * 10, 0, 180);
+        } else if (editField == EDIT_TEMP) {
+            config.requiredTemp = stepValue(config.requiredTemp, diff, TEMP_MIN, TEMP_MAX);
+        } else if (editField == EDIT_R1) {
+            config.r1Threshold = stepValue(config.r1Threshold, diff, THRESHOLD_MIN, THRESHOLD_MAX);
+        } else if (editField == EDIT_R2) {
+            config.r2Threshold = stepValue(config.r2Threshold, diff, THRESHOLD_MIN, THRESHOLD_MAX);
+        }
+        render();
+    }
+
+    void nextField() {
+        if (!configLoaded || editField == EDIT_SAVING) {
+            return;
+        }
+        if (editField == EDIT_R2) {
+            editField = EDIT_SAVING;
+            config.mask = CFG_ALL;
+            if (!sendConfig()) {
+                editField = EDIT_R2;
+                configRejected = true;
+            }
+        } else {
+            editField++;
+        }
+        render();
+    }
+
+    void startEdit() {
+        displayState = STATE_EDIT;
+        editField = EDIT_ANGLE;
+        configLoaded = false;
+        configRejected = false;
+        render();
+        sendCommand(Frame::TYPE_GET_CONFIG);
+    }
+
+    void sendCommand(uint8_t cmd) {
+        oled->drawUTF8(118, 14, "\xBB");
+        oled->sendBuffer();
+
+        // При исчерпанном бюджете эфира индикатор остается до следующей отрисовки.
+        bool sent = radio.send(TxScheduler::PRIORITY_NORMAL, cmd, nullptr, 0);
+
+        oled->drawUTF8(118, 14, sent ? " " : "!");
+        oled->sendBuffer();
+    }
+
+    void requestConfig() {
+        syncRequestedAt = millis();
+        radio.send(TxScheduler::PRIORITY_NORMAL, Frame::TYPE_GET_CONFIG, nullptr, 0);
+    }
+
+    bool sendConfig() {
+        return radio.send(TxScheduler::PRIORITY_NORMAL, Frame::TYPE_SET_CONFIG, &config, sizeof(Frame::Config));
+    }
+
+    void capture(const uint8_t *packet, uint8_t length, unsigned long m) {
+        uint8_t header[Capture::HEADER_SIZE];
+        Serial.write(header, Capture::header(header, m, (int16_t) radio.getRssi(), radio.getSnr(), length));
+        Serial.write(packet, length);
+    }
+
+    void receiveConfig(const Frame::Config &received) {
+        uint8_t requested = config.mask;
+        bool saving = editField == EDIT_SAVING;
+        config = received;
+        configLoaded = true;
+
+        if (displayState != STATE_EDIT) {
+            return;
+        }
+        if (saving) {
+            configRejected = (received.mask & requested) != requested;
+            if (configRejected) {
+                editField = EDIT_ANGLE;
+            } else {
+                displayState = STATE_DISPLAY;
+            }
+        }
+        render();
+    }
+
+    void renderTrend() {
+        trend.advance(millis());
+        oled->drawUTF8(2, 12, trendPage == TREND_TEMP ? "24 ч" : "реле 24 ч");
+        if (!trend.hasData()) {
+            oled->drawUTF8(30, 40, "нет данных");
+            return;
+        }
+
+        if (trendPage == TREND_TEMP) {
+            uint8_t low = trend.getPlotMin();
+            uint8_t high = trend.getPlotMax();
+            char range[24]{};
+            Format::temperature(range, TrendBuffer::dequantize(low));
+            strcat(range, "..");
+            Format::temperature(range, TrendBuffer::dequantize(high));
+            oled->drawUTF8(40, 12, range);
+
+            // Интервал - столбец шириной 2 точки от минимума до максимума, новые справа.
+            uint8_t span = high > low ? high - low : 1;
+            for (uint8_t age = 0; age < TrendBuffer::BUCKETS; age++) {
+                if (trend.isEmpty(age)) {
+                    continue;
+                }
+                uint8_t top = 63 - (uint8_t) ((uint16_t) (trend.getMax(age) - low) * 46 / span);
+                uint8_t bottom = 63 - (uint8_t) ((uint16_t) (trend.getMin(age) - low) * 46 / span);
+                oled->drawBox(126 - age * 2, top, 2, bottom - top + 1);
+            }
+        } else {
+            oled->drawUTF8(2, 30, "Р1");
+            oled->drawUTF8(2, 54, "Р2");
+            for (uint8_t age = 0; age < TrendBuffer::BUCKETS; age++) {
+                uint8_t d1 = trend.getDuty(age, 1) * 20 / TrendBuffer::DUTY_MAX;
+                uint8_t d2 = trend.getDuty(age, 2) * 20 / TrendBuffer::DUTY_MAX;
+                oled->drawBox(126 - age * 2, 38 - d1, 2, d1);
+                oled->drawBox(126 - age * 2, 63 - d2, 2, d2);
+            }
+        }
+    }
+
+    void renderDiag() {
+        oled->drawUTF8(25, 12, "диагностика");
+
+        char line[40]{};
+        sprintf(line, "RSSI %d dBm, отбр. %lu", radio.getRssi(), dropped);
+        oled->drawUTF8(2, 26, line);
+
+        strcpy(line, "SNR ");
+        Format::snr(line, radio.getSnr());
+        strcat(line, " dB");
+        oled->drawUTF8(2, 38, line);
+
+        if (radio.getLowPowerRx()) {
+            sprintf(line, "CAD %lu, %lu мкА", radio.getLowPowerRx()->getWakeups(),
+                    radio.getLowPowerRx()->getAverageCurrent());
+        } else {
+            strcpy(line, "прием постоянный");
+        }
+        oled->drawUTF8(2, 50, line);
+
+        sprintf(line, "эфир %lu/%lu с", (unsigned long) radio.getScheduler().remaining(millis()) / 1000,
+                (unsigned long) radio.getScheduler().getBudget() / 1000);
+        oled->drawUTF8(2, 62, line);
+    }
+
 public:
+    static const uint8_t STATE_DISPLAY = 0;
+    static const uint8_t STATE_EDIT = 1;
+    static const uint8_t STATE_DIAG = 2;
+    static const uint8_t STATE_TREND = 3;
+
+    static const uint8_t TREND_TEMP = 0;
+    static const uint8_t TREND_RELAY = 1;
+
+    static const uint8_t EDIT_ANGLE = 0;
+    static const uint8_t EDIT_TEMP = 1;
+    static const uint8_t EDIT_R1 = 2;
+    static const uint8_t EDIT_R2 = 3;
+    static const uint8_t EDIT_SAVING = 4;
+
+    static const uint8_t BTN_UP_LONG = 10;
+    static const uint8_t BTN_DOWN_LONG = 11;
+    static const uint16_t LONG_PRESS = 1500;
+
     HomeController(uint8_t cs, uint8_t dc, uint8_t reset) : Controller(cs, dc, reset) {
         oled = new U8G2_SH1106_128X64_NONAME_F_4W_HW_SPI(U8G2_R0, cs, dc, reset);
         oled->begin();
+
+        EEPROM.setMemPool(0, EEPROMSizeNano);
+        radio.beginAuth(AUTH ? AUTH_KEY : nullptr);
+        // После перезагрузки прием ждет кадр синхронизации: удаленный блок отвечает им на запрос настроек.
+        if (radio.isAuthenticated()) {
+            requestConfig();
+        }
     }
 
     bool relayIsOn(uint8_t pin) override {
         if (pin == R1) {
-            return (bool) r1IsOn;
+            return remote.r1;
         }
         if (pin == R2) {
-            return (bool) r2IsOn;
+            return remote.r2;
         }
         return false;
     }
@@ -89,7 +350,13 @@ public:
 
         oled->setFont(u8g2_font_mercutio_basic_nbp_t_all);
 
-        if (this->errCode == ERR_TEMP) {
+        if (displayState == STATE_EDIT) {
+            renderEdit();
+        } else if (displayState == STATE_DIAG) {
+            renderDiag();
+        } else if (displayState == STATE_TREND) {
+            renderTrend();
+        } else if (remote.errCode == ERR_TEMP) {
             oled->drawUTF8(25, 20, "ошибка датчика");
             oled->drawUTF8(30, 40, "температуры!");
         } else if (this->noSignal != 0) {
@@ -99,7 +366,7 @@ public:
             oled->drawUTF8(50, 50, noSignalOutput);
         } else {
             char snrOutput[10]{};
-            dtostrf(snr, 2, 0, snrOutput);
+            Format::snr(snrOutput, radio.getSnr());
             strcat(snrOutput, "dB");
             oled->drawUTF8(80, 14, snrOutput);
 
@@ -129,29 +396,35 @@ public:
             oled->setDrawColor(2);
             oled->setFontMode(1);
 
-            float displayAngle = round((uint8_t) angle.i / 2);
+            uint8_t displayAngle = (uint8_t) remote.angle / 2;
             char angleString[18]{};
             char angleValueString[6]{};
             strcat(angleString, "вент.");
-            dtostrf(displayAngle, 2, 0, angleValueString);
+            sprintf(angleValueString, "%2u", displayAngle);
             strcat(angleString, angleValueString);
             strcat(angleString, "%");
             oled->drawUTF8(40, 33, angleString);
 
-            long barLen = round(124 * displayAngle / 100);
+            long barLen = (124L * displayAngle + 50) / 100;
             oled->drawBox(2, 21, barLen, 14);
             oled->setDrawColor(1);
             oled->setFontMode(0);
 
             char humOutput[16]{};
             strcat(humOutput, "влаж. ");
-            Format::humidity(humOutput, currentHum.f);
+            Format::humidity(humOutput, remote.hum);
             oled->drawUTF8(65, 49, humOutput);
 
+            char rangeOutput[20]{};
+            Format::temperature(rangeOutput, remote.tempMin);
+            strcat(rangeOutput, "/");
+            Format::temperature(rangeOutput, remote.tempMax);
+            oled->drawUTF8(65, 62, rangeOutput);
+
             oled->setFont(u8g2_font_logisoso16_tf);
 
             char tempOutput[10]{};
-            Format::temperature(tempOutput, currentTemp.f, true);
+            Format::temperature(tempOutput, remote.temp, true);
             oled->drawUTF8(2, 60, tempOutput);
         }
 
@@ -159,29 +432,11 @@ public:
     }
 
     void upClick() {
-        oled->drawUTF8(118, 14, "\xBB");
-        oled->sendBuffer();
-
-        LoRa.beginPacket();
-        LoRa.write(CMD_UP);
-        LoRa.endPacket();
-        LoRa.receive();
-
-        oled->drawUTF8(118, 14, " ");
-        oled->sendBuffer();
+        sendCommand(Frame::TYPE_UP);
     }
 
     void downClick() {
-        oled->drawUTF8(118, 14, "\xBB");
-        oled->sendBuffer();
-
-        LoRa.beginPacket();
-        LoRa.write(CMD_DOWN);
-        LoRa.endPacket();
-        LoRa.receive();
-
-        oled->drawUTF8(118, 14, " ");
-        oled->sendBuffer();
+        sendCommand(Frame::TYPE_DOWN);
     }
 
     void tick() {
@@ -195,30 +450,45 @@ public:
             noSignal = m - lastReceive;
         }
 
-        int packetSize = LoRa.parsePacket();
+        if (!radio.isSynced() && (m - syncRequestedAt) >= syncRetry) {
+            requestConfig();
+            if (syncRetry < SYNC_RETRY_MAX) {
+                syncRetry *= 2;
+            }
+        }
+
+        int packetSize = radio.available();
         if (packetSize) {
             oled->drawUTF8(118, 14, "\xAB");
             oled->sendBuffer();
 
-            errCode = (uint8_t) LoRa.read();
-
-            currentTemp.b[0] = (uint8_t) LoRa.read();
-            currentTemp.b[1] = (uint8_t) LoRa.read();
-            currentTemp.b[2] = (uint8_t) LoRa.read();
-            currentTemp.b[3] = (uint8_t) LoRa.read();
-
-            currentHum.b[0] = (uint8_t) LoRa.read();
-            currentHum.b[1] = (uint8_t) LoRa.read();
-            currentHum.b[2] = (uint8_t) LoRa.read();
-            currentHum.b[3] = (uint8_t) LoRa.read();
-
-            angle.b[0] = (uint8_t) LoRa.read();
-            angle.b[1] = (uint8_t) LoRa.read();
+            uint8_t packet[Frame::MAX_SIZE];
+            uint8_t length = radio.read(packet, packetSize);
 
-            r1IsOn = (uint8_t) LoRa.read();
-            r2IsOn = (uint8_t) LoRa.read();
+            if (CAPTURE && length) {
+                capture(packet, length, m);
+            }
 
-            snr = LoRa.packetSnr();
+            uint8_t type = radio.check(packet, length);
+            // Удаленный блок мог перезагрузиться и ждать команды только с нового блока счетчика.
+            if (type != Frame::TYPE_INVALID && Frame::isSync(packet)) {
+                radio.requestSync();
+            }
+            if (type == Frame::TYPE_TELEMETRY) {
+                remote.apply(*Frame::view<Frame::Telemetry>(packet));
+                // При ошибке датчика температура в кадре не замер, а до полной медианы
+                // не отфильтрована от выбросов: в тренд идут только проверенные значения.
+                if (remote.errCode != ERR_TEMP && remote.errCode != ERR_WARMUP) {
+                    trend.add(m, remote.tempMin, remote.tempMax, remote.r1, remote.r2);
+                }
+            } else if (type == Frame::TYPE_CONFIG) {
+                receiveConfig(*Frame::view<Frame::Config>(packet));
+            } else {
+                dropped++;
+                oled->drawUTF8(118, 14, " ");
+                oled->sendBuffer();
+                return;
+            }
 
             lastReceive = m;
             noSignal = 0;
@@ -230,10 +500,43 @@ public:
 
     void call(uint8_t type, uint8_t idx) override
     {
+        if (displayState == STATE_EDIT) {
+            if (type == CMD_UP) {
+                editValue(1);
+            } else if (type == CMD_DOWN) {
+                editValue(-1);
+            } else if (type == BTN_UP_LONG) {
+                nextField();
+            } else if (type == BTN_DOWN_LONG) {
+                displayState = STATE_DISPLAY;
+                render();
+            }
+            return;
+        }
+
+        // На экране истории короткие нажатия листают графики.
+        if (displayState == STATE_TREND && (type == CMD_UP || type == CMD_DOWN)) {
+            trendPage = trendPage == TREND_TEMP ? TREND_RELAY : TREND_TEMP;
+            render();
+            return;
+        }
+
         if (type ==  CMD_UP) {
             upClick();
         } else if (type == CMD_DOWN) {
             downClick();
+        } else if (type == BTN_UP_LONG) {
+            startEdit();
+        } else if (type == BTN_DOWN_LONG) {
+            // Основной экран -> история -> диагностика -> основной экран.
+            if (displayState == STATE_DISPLAY) {
+                displayState = STATE_TREND;
+            } else if (displayState == STATE_TREND) {
+                displayState = STATE_DIAG;
+            } else {
+                displayState = STATE_DISPLAY;
+            }
+            render();
         }
     }
 };
@@ -248,16 +551,21 @@ void renderDisplay() {
 }
 
 void setup() {
+    if (CAPTURE) {
+        Serial.begin(CAPTURE_BAUD);
+    }
     ctrl = new HomeController(OLED_CS, OLED_DC, OLED_RESET);
     ctrl->render();
     task = new Task(1);
     task->each(renderDisplay, 1000);
 
-    swUp = new Button(A1, 1, false);
+    swUp = new Button(A1, 2, false);
     swUp->addHandler(ctrl, Controller::CMD_UP);
+    swUp->addHandler(ctrl, HomeController::BTN_UP_LONG, HomeController::LONG_PRESS);
 
-    swDown = new Button(A0, 1, false);
+    swDown = new Button(A0, 2, false);
     swDown->addHandler(ctrl, Controller::CMD_DOWN);
+    swDown->addHandler(ctrl, HomeController::BTN_DOWN_LONG, HomeController::LONG_PRESS);
 }
 
 void loop() {
@@ -0,0 +1,73 @@
+#include "AcceleratedEncoder.h"
+
+// Направление перехода по индексу (новое состояние | старое состояние << 2).
+static const int8_t KNOBDIR[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+
+AcceleratedEncoder::AcceleratedEncoder(uint8_t pin1, uint8_t pin2) {
+    this->pin1 = pin1;
+    this->pin2 = pin2;
+}
+
+uint8_t AcceleratedEncoder::readPins() const {
+    return (uint8_t) (digitalRead(pin1) | (digitalRead(pin2) << 1));
+}
+
+void AcceleratedEncoder::begin() {
+    pinMode(pin1, INPUT_PULLUP);
+    pinMode(pin2, INPUT_PULLUP);
+    state = readPins();
+
+    *digitalPinToPCMSK(pin1) |= bit(digitalPinToPCMSKbit(pin1));
+    *digitalPinToPCMSK(pin2) |= bit(digitalPinToPCMSKbit(pin2));
+    PCIFR |= bit(digitalPinToPCICRbit(pin1)) | bit(digitalPinToPCICRbit(pin2));
+    *digitalPinToPCICR(pin1) |= bit(digitalPinToPCICRbit(pin1));
+    *digitalPinToPCICR(pin2) |= bit(digitalPinToPCICRbit(pin2));
+}
+
+void AcceleratedEncoder::tick() {
+    update(readPins(), millis());
+}
+
+void AcceleratedEncoder::update(uint8_t pins, unsigned long now) {
+    if (pins == state) {
+        return;
+    }
+    position += KNOBDIR[pins | (state << 2)];
+    state = pins;
+
+    // Щелчок фиксируется в положении покоя, когда оба вывода в 0.
+    if (pins != 0) {
+        return;
+    }
+    int8_t detents = position / 4;
+    if (detents == 0) {
+        return;
+    }
+    position -= detents * 4;
+
+    int8_t dir = detents > 0 ? 1 : -1;
+    uint8_t factor = 1;
+    // При смене направления ускорение сбрасывается, дребезг не дает рывков.
+    if (dir == direction) {
+        unsigned long interval = now - lastDetent;
+        if (interval < FAST_INTERVAL) {
+            factor = ACCEL_FAST;
+        } else if (interval < MEDIUM_INTERVAL) {
+            factor = ACCEL_MEDIUM;
+        }
+    }
+    direction = dir;
+    lastDetent = now;
+
+    steps += detents;
+    accelerated += detents * factor;
+}
+
+int16_t AcceleratedEncoder::take(bool accelerate) {
+    noInterrupts();
+    int16_t delta = accelerate ? accelerated : steps;
+    steps = 0;
+    accelerated = 0;
+    interrupts();
+    return delta;
+}
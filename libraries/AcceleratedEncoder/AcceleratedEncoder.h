@@ -0,0 +1,48 @@
+#ifndef WINTERHOME_ACCELERATEDENCODER_H
+#define WINTERHOME_ACCELERATEDENCODER_H
+
+#include <Arduino.h>
+
+// Энкодер с декодированием в прерывании PCINT и ускорением при быстром вращении.
+// Обработчик прерывания объявляется в скетче и вызывает tick(), для A2/A3 на Nano:
+// ISR(PCINT1_vect) { encoder.tick(); }
+// Накопленное смещение забирается из основного цикла через take(), поэтому
+// щелчки не теряются во время отрисовки, записи в EEPROM и передачи.
+class AcceleratedEncoder {
+    // Интервал между щелчками в одну сторону, мс, ниже которого шаг умножается.
+    static const uint8_t FAST_INTERVAL = 25;
+    static const uint8_t MEDIUM_INTERVAL = 80;
+
+    static const uint8_t ACCEL_FAST = 10;
+    static const uint8_t ACCEL_MEDIUM = 5;
+
+    uint8_t pin1;
+    uint8_t pin2;
+
+    uint8_t state = 0;
+    int8_t position = 0;
+    int8_t direction = 0;
+    unsigned long lastDetent = 0;
+
+    volatile int16_t steps = 0;
+    volatile int16_t accelerated = 0;
+
+    uint8_t readPins() const;
+
+public:
+    AcceleratedEncoder(uint8_t pin1, uint8_t pin2);
+
+    // Включает подтяжку и прерывание по изменению уровня на обоих выводах.
+    void begin();
+
+    // Вызывается из обработчика прерывания.
+    void tick();
+
+    // Обрабатывает новое состояние выводов (бит 0 - pin1, бит 1 - pin2) в момент now, мс.
+    void update(uint8_t pins, unsigned long now);
+
+    // Возвращает смещение в щелчках с прошлого вызова (с ускорением или без) и обнуляет его.
+    int16_t take(bool accelerate);
+};
+
+#endif //WINTERHOME_ACCELERATEDENCODER_H
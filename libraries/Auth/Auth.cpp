@@ -0,0 +1,172 @@
+#include <string.h>
+#include "Auth.h"
+
+#define ROTL(x, b) (uint64_t) (((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND            \
+    do {                    \
+        v0 += v1;           \
+        v1 = ROTL(v1, 13);  \
+        v1 ^= v0;           \
+        v0 = ROTL(v0, 32);  \
+        v2 += v3;           \
+        v3 = ROTL(v3, 16);  \
+        v3 ^= v2;           \
+        v0 += v3;           \
+        v3 = ROTL(v3, 21);  \
+        v3 ^= v0;           \
+        v2 += v1;           \
+        v1 = ROTL(v1, 17);  \
+        v1 ^= v2;           \
+        v2 = ROTL(v2, 32);  \
+    } while (0)
+
+static uint64_t readLE64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int8_t i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+Auth::Auth(const uint8_t *key, uint8_t txId, uint8_t rxId) {
+    memcpy(this->key, key, sizeof(this->key));
+    this->txId = txId;
+    this->rxId = rxId;
+}
+
+uint64_t Auth::siphash(const uint8_t *key, const uint8_t *data, size_t length) {
+    uint64_t k0 = readLE64(key);
+    uint64_t k1 = readLE64(key + 8);
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+    const uint8_t *end = data + (length & ~(size_t) 7);
+    for (; data != end; data += 8) {
+        uint64_t m = readLE64(data);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    uint8_t last[8]{};
+    memcpy(last, data, length & 7);
+    last[7] = (uint8_t) length;
+    uint64_t b = readLE64(last);
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+uint32_t Auth::tag(const uint8_t *frame, uint8_t length, uint32_t counter, uint8_t id) const {
+    uint8_t message[64];
+    if (length > sizeof(message) - 5) {
+        return 0xFFFFFFFF;
+    }
+    memcpy(message, frame, length);
+    message[length] = (uint8_t) counter;
+    message[length + 1] = (uint8_t) (counter >> 8);
+    message[length + 2] = (uint8_t) (counter >> 16);
+    message[length + 3] = (uint8_t) (counter >> 24);
+    message[length + 4] = id;
+    return (uint32_t) siphash(key, message, length + 5) & 0xFFFFFF;
+}
+
+void Auth::begin(uint32_t txStored, uint32_t rxStored) {
+    // Чистая EEPROM читается как 0xFFFFFFFF.
+    txCounter = txStored == 0xFFFFFFFF ? 0 : txStored;
+    rxCounter = rxStored == 0xFFFFFFFF ? 0 : rxStored;
+    txLease = txCounter + LEASE;
+    syncPending = true;
+}
+
+bool Auth::isSyncDue() const {
+    return syncPending || ((txCounter + 1) & (LEASE - 1)) == 0;
+}
+
+void Auth::requestSync() {
+    syncPending = true;
+}
+
+uint8_t Auth::sign(uint8_t *frame, uint8_t length, bool sync) {
+    if (sync && syncPending) {
+        // Начало следующего блока: больше сохраненного получателем конца блока.
+        txCounter = (txCounter | (LEASE - 1)) + 1;
+        syncPending = false;
+    } else {
+        // Кадр синхронизации без запроса несет полный счетчик, но блок не открывает.
+        txCounter++;
+    }
+    if (txCounter >= txLease) {
+        txLease = txCounter + LEASE;
+    }
+    uint32_t t = tag(frame, length, txCounter, txId);
+    uint8_t *trailer = frame + length;
+    if (sync) {
+        *trailer++ = (uint8_t) txCounter;
+        *trailer++ = (uint8_t) (txCounter >> 8);
+        *trailer++ = (uint8_t) (txCounter >> 16);
+        *trailer++ = (uint8_t) (txCounter >> 24);
+    } else {
+        *trailer++ = (uint8_t) txCounter;
+    }
+    trailer[0] = (uint8_t) t;
+    trailer[1] = (uint8_t) (t >> 8);
+    trailer[2] = (uint8_t) (t >> 16);
+    return length + (sync ? SYNC_TRAILER_SIZE : TRAILER_SIZE);
+}
+
+bool Auth::verify(const uint8_t *frame, uint8_t length, bool sync) {
+    if (sync) {
+        if (length < SYNC_TRAILER_SIZE) {
+            return false;
+        }
+        length -= SYNC_TRAILER_SIZE;
+        const uint8_t *trailer = frame + length;
+        uint32_t counter = (uint32_t) trailer[0] | ((uint32_t) trailer[1] << 8) | ((uint32_t) trailer[2] << 16) |
+                           ((uint32_t) trailer[3] << 24);
+        uint32_t received = (uint32_t) trailer[4] | ((uint32_t) trailer[5] << 8) | ((uint32_t) trailer[6] << 16);
+        if (counter <= rxCounter || tag(frame, length, counter, rxId) != received) {
+            return false;
+        }
+        rxCounter = counter;
+        return true;
+    }
+    if (length < TRAILER_SIZE) {
+        return false;
+    }
+    length -= TRAILER_SIZE;
+    const uint8_t *trailer = frame + length;
+    uint32_t received = (uint32_t) trailer[1] | ((uint32_t) trailer[2] << 8) | ((uint32_t) trailer[3] << 16);
+
+    uint32_t counter = (rxCounter & ~(uint32_t) 0xFF) | trailer[0];
+    if (counter <= rxCounter) {
+        counter += 256;
+    }
+    for (uint8_t i = 0; i < MAX_RESYNC; i++, counter += 256) {
+        if (tag(frame, length, counter, rxId) == received) {
+            rxCounter = counter;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Auth::getTxLease() const {
+    return txLease;
+}
+
+uint32_t Auth::getRxLease() const {
+    return rxCounter | (LEASE - 1);
+}
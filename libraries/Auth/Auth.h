@@ -0,0 +1,71 @@
+#ifndef WINTERHOME_AUTH_H
+#define WINTERHOME_AUTH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Аутентификация кадров: к кадру добавляется младший байт счетчика и
+// 24 бита SipHash-2-4 от кадра, полного счетчика и идентификатора отправителя.
+// Кадр синхронизации несет полный счетчик, его трейлер 7 байт вместо 4 (SYNC_TRAILER_SIZE).
+// Получатель восстанавливает полный счетчик по последнему принятому и
+// отбрасывает кадры со счетчиком не больше него (защита от повтора).
+//
+// Если получатель пропустил больше MAX_RESYNC блоков, младшего байта не
+// хватает. Тогда его догоняет кадр синхронизации с полным счетчиком: он
+// принимается при любом счетчике больше последнего принятого. Отправитель
+// синхронизирует первым кадром после begin(), каждым кадром с начала блока
+// и по requestSync(), например в ответ на запрос перезагрузившегося получателя.
+// Кадр можно подписать синхронизацией и без этого (sign() с sync = true): он
+// несет полный счетчик, но следующий блок не открывает и EEPROM не трогает.
+//
+// Счетчики сохраняются в EEPROM блоками по LEASE: после перезагрузки
+// отправитель продолжает с начала следующего блока, получатель - с конца
+// блока последнего принятого кадра, поэтому принятый кадр не принимается
+// повторно, а запись в EEPROM происходит раз в LEASE кадров. Кадр
+// синхронизации всегда открывает новый блок и проходит у такого получателя.
+class Auth {
+    uint8_t key[16];
+    uint8_t txId;
+    uint8_t rxId;
+
+    uint32_t txCounter = 0;
+    uint32_t txLease = 0;
+    uint32_t rxCounter = 0;
+    bool syncPending = false;
+
+    uint32_t tag(const uint8_t *frame, uint8_t length, uint32_t counter, uint8_t id) const;
+
+public:
+    static const uint8_t TAG_SIZE = 3;
+    static const uint8_t TRAILER_SIZE = 1 + TAG_SIZE;
+    static const uint8_t SYNC_TRAILER_SIZE = 4 + TAG_SIZE;
+    static const uint16_t LEASE = 256;
+    // Сколько раз по 256 получатель ищет счетчик вперед после пропусков и перезагрузок отправителя.
+    static const uint8_t MAX_RESYNC = 16;
+
+    Auth(const uint8_t *key, uint8_t txId, uint8_t rxId);
+
+    // Продолжает счет с сохраненных значений getTxLease() и getRxLease().
+    void begin(uint32_t txStored, uint32_t rxStored);
+
+    // Нужно ли подписать следующий кадр как кадр синхронизации.
+    bool isSyncDue() const;
+
+    // Подписать следующий кадр как кадр синхронизации.
+    void requestSync();
+
+    // Дописывает трейлер к кадру (буфер должен вмещать TRAILER_SIZE или при sync
+    // SYNC_TRAILER_SIZE байт), возвращает новую длину.
+    uint8_t sign(uint8_t *frame, uint8_t length, bool sync = false);
+
+    // Проверяет кадр с трейлером и продвигает счетчик приема.
+    bool verify(const uint8_t *frame, uint8_t length, bool sync = false);
+
+    uint32_t getTxLease() const;
+
+    uint32_t getRxLease() const;
+
+    static uint64_t siphash(const uint8_t *key, const uint8_t *data, size_t length);
+};
+
+#endif //WINTERHOME_AUTH_H
@@ -0,0 +1,36 @@
+#include "Capture.h"
+
+uint8_t Capture::header(uint8_t *out, uint32_t time, int16_t rssi, int8_t snr, uint8_t length) {
+    out[0] = SYNC_0;
+    out[1] = SYNC_1;
+    out[2] = (uint8_t) time;
+    out[3] = (uint8_t) (time >> 8);
+    out[4] = (uint8_t) (time >> 16);
+    out[5] = (uint8_t) (time >> 24);
+    out[6] = (uint8_t) rssi;
+    out[7] = (uint8_t) ((uint16_t) rssi >> 8);
+    out[8] = (uint8_t) snr;
+    out[9] = length;
+    return HEADER_SIZE;
+}
+
+bool Capture::next(const uint8_t *data, size_t size, size_t &offset, Record &record) {
+    while (offset + HEADER_SIZE <= size) {
+        const uint8_t *h = data + offset;
+        if (h[0] != SYNC_0 || h[1] != SYNC_1) {
+            offset++;
+            continue;
+        }
+        if (offset + HEADER_SIZE + h[9] > size) {
+            return false;
+        }
+        record.time = (uint32_t) h[2] | ((uint32_t) h[3] << 8) | ((uint32_t) h[4] << 16) | ((uint32_t) h[5] << 24);
+        record.rssi = (int16_t) ((uint16_t) h[6] | ((uint16_t) h[7] << 8));
+        record.snr = (int8_t) h[8];
+        record.length = h[9];
+        record.frame = h + HEADER_SIZE;
+        offset += HEADER_SIZE + record.length;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,37 @@
+#ifndef WINTERHOME_CAPTURE_H
+#define WINTERHOME_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Формат записи принятых кадров для отладки. Каждая запись - заголовок
+// фиксированной длины (little-endian) и следом байты кадра как они пришли из эфира.
+//
+//  0  2  sync    0xA5 0x5A
+//  2  4  time    millis() приемника
+//  6  2  rssi    dBm, со знаком
+//  8  1  snr     SNR в четвертях дБ, со знаком
+//  9  1  length  длина кадра
+class Capture {
+public:
+    static const uint8_t SYNC_0 = 0xA5;
+    static const uint8_t SYNC_1 = 0x5A;
+    static const uint8_t HEADER_SIZE = 10;
+
+    struct Record {
+        uint32_t time;
+        int16_t rssi;
+        int8_t snr;
+        uint8_t length;
+        const uint8_t *frame;
+    };
+
+    // Заполняет заголовок записи, возвращает HEADER_SIZE.
+    static uint8_t header(uint8_t *out, uint32_t time, int16_t rssi, int8_t snr, uint8_t length);
+
+    // Читает запись из буфера начиная с offset. Мусор между записями пропускается.
+    // Возвращает false, если полной записи в буфере больше нет.
+    static bool next(const uint8_t *data, size_t size, size_t &offset, Record &record);
+};
+
+#endif //WINTERHOME_CAPTURE_H
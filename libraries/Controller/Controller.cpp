@@ -1,12 +1,14 @@
 #include "Controller.h"
 
 Controller::Controller(uint8_t cs, uint8_t dc, uint8_t reset) {
-    // Задержка перед инициализацией.
-    delay(1000);
-
-    LoRa.begin(433E6);
-    LoRa.setTxPower(17);
-    LoRa.setSpreadingFactor(12);
-    LoRa.enableCrc();
+    LoRa.begin(RADIO.frequency);
+    LoRa.setTxPower(RADIO.txPower);
+    LoRa.setSignalBandwidth(RADIO.bandwidth);
+    LoRa.setSpreadingFactor(RADIO.spreadingFactor);
+    LoRa.setCodingRate4(RADIO.codingRate);
+    LoRa.setPreambleLength(RADIO.preamble);
+    if (RADIO.crc) {
+        LoRa.enableCrc();
+    }
     LoRa.idle();
 }
\ No newline at end of file
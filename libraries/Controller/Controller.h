@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Format.h>
 #include <LoRa.h>
+#include <RadioProfile.h>
 #include <U8g2lib.h>
 
 const uint8_t R1 = A0;
@@ -0,0 +1,130 @@
+#ifndef WINTERHOME_FIXED_H
+#define WINTERHOME_FIXED_H
+
+#include <stdint.h>
+
+// Число с фиксированной точкой: хранится raw = x * Scale в целом типе Rep.
+// Scale = 256 дает Q8.8, Scale = 100 - сотые доли. На ATmega328 нет FPU, поэтому
+// сравнение и сложение выполняются в целых, float нужен только на границе с датчиком.
+template<typename Rep, int32_t Scale>
+class Fixed {
+    Rep raw;
+
+    constexpr Fixed(Rep raw, bool) : raw(raw)
+    {}
+
+    // Деление с округлением к ближайшему.
+    static constexpr int32_t divide(int32_t n, int32_t d)
+    {
+        return n < 0 ? (n - d / 2) / d : (n + d / 2) / d;
+    }
+
+public:
+    static const int32_t SCALE = Scale;
+
+    constexpr Fixed() : raw(0)
+    {}
+
+    static constexpr Fixed fromRaw(Rep value)
+    {
+        return Fixed(value, true);
+    }
+
+    static constexpr Fixed fromInt(int32_t value)
+    {
+        return Fixed((Rep) (value * Scale), true);
+    }
+
+    // Значение в долях 1/divisor, например fromFraction(5, 10) = 0.5.
+    static constexpr Fixed fromFraction(int32_t value, int32_t divisor)
+    {
+        return Fixed((Rep) divide(value * Scale, divisor), true);
+    }
+
+    static constexpr Fixed fromFloat(float value)
+    {
+        return Fixed((Rep) (value < 0 ? value * Scale - 0.5f : value * Scale + 0.5f), true);
+    }
+
+    constexpr Rep toRaw() const
+    {
+        return raw;
+    }
+
+    // Округленное значение в долях 1/divisor, например в десятых при divisor = 10.
+    constexpr int32_t toFraction(int32_t divisor) const
+    {
+        return divide((int32_t) raw * divisor, Scale);
+    }
+
+    constexpr float toFloat() const
+    {
+        return (float) raw / Scale;
+    }
+
+    constexpr Fixed operator+(Fixed other) const
+    {
+        return Fixed((Rep) (raw + other.raw), true);
+    }
+
+    constexpr Fixed operator-(Fixed other) const
+    {
+        return Fixed((Rep) (raw - other.raw), true);
+    }
+
+    constexpr Fixed operator-() const
+    {
+        return Fixed((Rep) -raw, true);
+    }
+
+    Fixed &operator+=(Fixed other)
+    {
+        raw += other.raw;
+        return *this;
+    }
+
+    Fixed &operator-=(Fixed other)
+    {
+        raw -= other.raw;
+        return *this;
+    }
+
+    constexpr bool operator==(Fixed other) const
+    {
+        return raw == other.raw;
+    }
+
+    constexpr bool operator!=(Fixed other) const
+    {
+        return raw != other.raw;
+    }
+
+    constexpr bool operator<(Fixed other) const
+    {
+        return raw < other.raw;
+    }
+
+    constexpr bool operator<=(Fixed other) const
+    {
+        return raw <= other.raw;
+    }
+
+    constexpr bool operator>(Fixed other) const
+    {
+        return raw > other.raw;
+    }
+
+    constexpr bool operator>=(Fixed other) const
+    {
+        return raw >= other.raw;
+    }
+};
+
+// Температура, влажность и пороги в сотых долях, диапазон -327.68..327.67.
+typedef Fixed<int16_t, 100> Centi;
+
+static_assert(Centi::fromFraction(5, 10).toRaw() == 50, "Centi rounding");
+static_assert(Centi::fromFraction(-1, 3).toRaw() == -33, "Centi rounding");
+static_assert(Centi::fromFloat(-20.004f).toFraction(10) == -200, "Centi rounding");
+
+#endif //WINTERHOME_FIXED_H
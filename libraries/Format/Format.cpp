@@ -1,17 +1,20 @@
 #include "Arduino.h"
 #include "Format.h"
 
-void Format::temperature(char *formatted, float tempInput) {
+void Format::temperature(char *formatted, Centi tempInput) {
     Format::temperature(formatted, tempInput, false);
 }
 
-void Format::temperature(char *formatted, float tempInput, bool c) {
+void Format::temperature(char *formatted, Centi tempInput, bool c) {
     char tempString[10]{};
 
-    if (tempInput < 0) {
+    // Вывод с одним знаком после запятой без float.
+    long tenths = tempInput.toFraction(10);
+    if (tenths < 0) {
         strcat(formatted, "-");
+        tenths = -tenths;
     }
-    dtostrf(abs(tempInput), 3, 1, tempString);
+    sprintf(tempString, "%ld.%ld", tenths / 10, tenths % 10);
     strcat(formatted, tempString);
     strcat(formatted, "°");
     if (c) {
@@ -19,15 +22,24 @@ void Format::temperature(char *formatted, float tempInput, bool c) {
     }
 }
 
-void Format::humidity(char *formatted, float h) {
-    char tempString[4]{};
-    dtostrf(h, 2, 0, tempString);
+void Format::humidity(char *formatted, Centi h) {
+    char tempString[6]{};
+    sprintf(tempString, "%2ld", (long) h.toFraction(1));
     strcat(formatted, tempString);
     strcat(formatted, "%");
 }
 
-void Format::pressure(char *formatted, float hpa, uint8_t type, bool units) {
+void Format::snr(char *formatted, int8_t quarterDb) {
     char tempString[6]{};
+    // Округление к ближайшему, половина - от нуля, как у dtostrf().
+    int db = (quarterDb + (quarterDb < 0 ? -2 : 2)) / 4;
+    sprintf(tempString, "%2d", db);
+    strcat(formatted, tempString);
+}
+
+void Format::pressure(char *formatted, float hpa, uint8_t type, bool units) {
+    // "1013.2" - 6 символов и нуль.
+    char tempString[8]{};
     if (type == Format::PRESSURE_HPA) {
         dtostrf(hpa, 2, 1, tempString);
         strcat(formatted, tempString);
@@ -1,15 +1,18 @@
 #ifndef ARDUINOEXAMPLE_TEMPERATURE_H
 #define ARDUINOEXAMPLE_TEMPERATURE_H
 
+#include <Fixed.h>
 
 class Format {
 public:
     const static uint8_t PRESSURE_HPA = 0;
     const static uint8_t PRESSURE_MMHG = 1;
 
-    static void temperature(char *formatted, float t);
-    static void temperature(char *formatted, float t, bool c);
-    static void humidity(char *formatted, float h);
+    static void temperature(char *formatted, Centi t);
+    static void temperature(char *formatted, Centi t, bool c);
+    static void humidity(char *formatted, Centi h);
+    // SNR в четвертях дБ (как в регистре SX127x), выводится в целых дБ.
+    static void snr(char *formatted, int8_t quarterDb);
     static void pressure(char *formatted, float hpa);
     static void pressure(char *formatted, float hpa, uint8_t type, bool units);
 };
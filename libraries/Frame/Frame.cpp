@@ -0,0 +1,49 @@
+#include <string.h>
+#include "Frame.h"
+
+int Frame::payloadSize(uint8_t type) {
+    switch (type) {
+        case TYPE_UP:
+        case TYPE_DOWN:
+        case TYPE_GET_CONFIG:
+            return 0;
+        case TYPE_SET_CONFIG:
+        case TYPE_CONFIG:
+            return sizeof(Config);
+        case TYPE_TELEMETRY:
+            return sizeof(Telemetry);
+        default:
+            return -1;
+    }
+}
+
+uint8_t Frame::encode(uint8_t *out, uint8_t type, const void *payload, uint8_t size, bool authenticated,
+                      bool sync) {
+    out[0] = MAGIC;
+    out[1] = authenticated ? (sync ? (VERSION | FLAG_AUTH | FLAG_SYNC) : (VERSION | FLAG_AUTH)) : VERSION;
+    out[2] = type;
+    if (size) {
+        memcpy(out + HEADER_SIZE, payload, size);
+    }
+    return HEADER_SIZE + size;
+}
+
+uint8_t Frame::validate(const uint8_t *data, size_t length) {
+    if (length < HEADER_SIZE || length > MAX_SIZE || data[0] != MAGIC ||
+        (data[1] & ~(FLAG_AUTH | FLAG_SYNC)) != VERSION) {
+        return TYPE_INVALID;
+    }
+    // Синхронизация счетчика бывает только у подписанных кадров.
+    if (isSync(data) && !isAuthenticated(data)) {
+        return TYPE_INVALID;
+    }
+    int size = payloadSize(data[2]);
+    if (size < 0) {
+        return TYPE_INVALID;
+    }
+    size += trailerSize(data);
+    if (length != (size_t) (HEADER_SIZE + size)) {
+        return TYPE_INVALID;
+    }
+    return data[2];
+}
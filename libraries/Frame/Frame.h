@@ -0,0 +1,94 @@
+#ifndef WINTERHOME_FRAME_H
+#define WINTERHOME_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Формат кадров между домашним и удаленным блоком.
+//
+//  0  1  magic    MAGIC
+//  1  1  version  VERSION с флагами FLAG_AUTH и FLAG_SYNC
+//  2  1  type     TYPE_*
+//  3  n  payload  структура типа, длина фиксирована для каждого типа
+//   4/7  trailer  только при FLAG_AUTH: счетчик и тег (см. Auth), при FLAG_SYNC
+//                 счетчик передается полностью
+//
+// Принятый кадр целиком лежит в буфере, поля читаются через view() без копирования.
+// Температура, влажность и пороги передаются в сотых долях (Centi::toRaw()).
+class Frame {
+public:
+    static const uint8_t MAGIC = 0x57;
+    static const uint8_t VERSION = 3;
+    static const uint8_t HEADER_SIZE = 3;
+    static const uint8_t MAX_SIZE = 32;
+    static const uint8_t FLAG_AUTH = 0x80;
+    static const uint8_t FLAG_SYNC = 0x40;
+    static const uint8_t TRAILER_SIZE = 4;
+    static const uint8_t SYNC_TRAILER_SIZE = 7;
+
+    static const uint8_t TYPE_INVALID = 0;
+    static const uint8_t TYPE_UP = 1;
+    static const uint8_t TYPE_DOWN = 2;
+    static const uint8_t TYPE_GET_CONFIG = 3;
+    static const uint8_t TYPE_SET_CONFIG = 4;
+    static const uint8_t TYPE_CONFIG = 0x80;
+    static const uint8_t TYPE_TELEMETRY = 0x81;
+
+    struct Telemetry {
+        uint8_t errCode;
+        int16_t temp;
+        int16_t hum;
+        int16_t angle;
+        uint8_t r1;
+        uint8_t r2;
+        // Температура за время с прошлой телеметрии.
+        int16_t tempMin;
+        int16_t tempMax;
+        int16_t tempMean;
+    } __attribute__((packed));
+
+    // Абсолютные настройки удаленного блока. В запросе mask - изменяемые поля,
+    // в ответе - принятые поля, значения всегда фактически примененные.
+    struct Config {
+        uint8_t mask;
+        int16_t angle;
+        int16_t requiredTemp;
+        int16_t r1Threshold;
+        int16_t r2Threshold;
+    } __attribute__((packed));
+
+    // Длина полезной нагрузки для типа кадра или -1 для неизвестного типа.
+    static int payloadSize(uint8_t type);
+
+    // Собирает кадр в out (не меньше MAX_SIZE байт), возвращает его длину без трейлера.
+    // sync - кадр синхронизации счетчика (только вместе с authenticated, см. Auth::isSyncDue()).
+    static uint8_t encode(uint8_t *out, uint8_t type, const void *payload, uint8_t size, bool authenticated,
+                          bool sync = false);
+
+    // Проверяет длину, magic и версию кадра. Возвращает тип или TYPE_INVALID.
+    static uint8_t validate(const uint8_t *data, size_t length);
+
+    static bool isAuthenticated(const uint8_t *data)
+    {
+        return (data[1] & FLAG_AUTH) != 0;
+    }
+
+    static bool isSync(const uint8_t *data)
+    {
+        return (data[1] & FLAG_SYNC) != 0;
+    }
+
+    // Длина трейлера, который дописывает Auth::sign() к собранному кадру.
+    static uint8_t trailerSize(const uint8_t *data)
+    {
+        return isAuthenticated(data) ? (isSync(data) ? SYNC_TRAILER_SIZE : TRAILER_SIZE) : 0;
+    }
+
+    template<typename T>
+    static const T *view(const uint8_t *data)
+    {
+        return reinterpret_cast<const T *>(data + HEADER_SIZE);
+    }
+};
+
+#endif //WINTERHOME_FRAME_H
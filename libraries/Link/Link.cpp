@@ -0,0 +1,15 @@
+#include "Link.h"
+
+uint8_t Link::check(Auth *auth, const uint8_t *packet, uint8_t length) {
+    uint8_t type = Frame::validate(packet, length);
+    if (type == Frame::TYPE_INVALID) {
+        return type;
+    }
+    if (!auth) {
+        return Frame::isAuthenticated(packet) ? Frame::TYPE_INVALID : type;
+    }
+    if (!Frame::isAuthenticated(packet) || !auth->verify(packet, length, Frame::isSync(packet))) {
+        return Frame::TYPE_INVALID;
+    }
+    return type;
+}
@@ -0,0 +1,17 @@
+#ifndef WINTERHOME_LINK_H
+#define WINTERHOME_LINK_H
+
+#include <stdint.h>
+#include <Frame.h>
+#include <Auth.h>
+
+// Правила приема кадра, общие для обоих блоков и хостовых утилит: формат
+// проверяет Frame, подпись и повтор - Auth. Блок без ключа принимает только
+// неподписанные кадры, блок с ключом - только подписанные.
+class Link {
+public:
+    // Возвращает тип кадра или Frame::TYPE_INVALID. auth == nullptr - аутентификация выключена.
+    static uint8_t check(Auth *auth, const uint8_t *packet, uint8_t length);
+};
+
+#endif //WINTERHOME_LINK_H
@@ -0,0 +1,100 @@
+#include "LowPowerRx.h"
+
+volatile uint8_t LowPowerRx::cadResult = LowPowerRx::CAD_IDLE;
+volatile int LowPowerRx::received = 0;
+
+void LowPowerRx::onCadDone(bool detected) {
+    cadResult = detected ? CAD_DETECTED : CAD_FREE;
+}
+
+void LowPowerRx::onReceive(int packetSize) {
+    received = packetSize;
+}
+
+LowPowerRx::LowPowerRx(uint16_t wakeInterval, uint16_t rxTimeout) {
+    this->wakeInterval = wakeInterval;
+    this->rxTimeout = rxTimeout;
+}
+
+void LowPowerRx::begin() {
+    LoRa.onCadDone(LowPowerRx::onCadDone);
+    LoRa.onReceive(LowPowerRx::onReceive);
+    startedAt = millis();
+    sleep();
+}
+
+void LowPowerRx::resume() {
+    sleep();
+}
+
+void LowPowerRx::sleep() {
+    LoRa.sleep();
+    state = STATE_SLEEP;
+    sleepPending = false;
+    stateStart = millis();
+}
+
+void LowPowerRx::addActive(unsigned long us) {
+    activeMicros += us;
+    activeMillis += activeMicros / 1000;
+    activeMicros %= 1000;
+}
+
+int LowPowerRx::tick() {
+    unsigned long m = millis();
+
+    if (sleepPending) {
+        sleep();
+        return 0;
+    }
+
+    if (state == STATE_SLEEP && (m - stateStart) >= wakeInterval) {
+        cadResult = CAD_IDLE;
+        received = 0;
+        wakeups++;
+        state = STATE_CAD;
+        stateStart = m;
+        cadStart = micros();
+        LoRa.channelActivityDetection();
+    } else if (state == STATE_CAD) {
+        uint8_t cad = cadResult;
+        if (cad != CAD_IDLE) {
+            addActive(micros() - cadStart);
+        }
+        if (cad == CAD_DETECTED) {
+            state = STATE_RX;
+            stateStart = m;
+            LoRa.receive();
+        } else if (cad == CAD_FREE || (m - stateStart) >= CAD_TIMEOUT) {
+            sleep();
+        }
+    } else if (state == STATE_RX) {
+        int packetSize = received;
+        if (packetSize) {
+            received = 0;
+            addActive((m - stateStart) * 1000);
+            // FIFO очищается во сне, поэтому радио засыпает только на следующем вызове.
+            LoRa.idle();
+            sleepPending = true;
+            return packetSize;
+        }
+        if ((m - stateStart) >= rxTimeout) {
+            addActive((m - stateStart) * 1000);
+            sleep();
+        }
+    }
+    return 0;
+}
+
+unsigned long LowPowerRx::getWakeups() const {
+    return wakeups;
+}
+
+unsigned long LowPowerRx::getAverageCurrent() const {
+    unsigned long total = millis() - startedAt;
+    if (total == 0) {
+        return 0;
+    }
+    unsigned long idle = total > activeMillis ? total - activeMillis : 0;
+    return (unsigned long) (((uint64_t) activeMillis * CURRENT_RX + (uint64_t) idle * CURRENT_SLEEP) / total);
+}
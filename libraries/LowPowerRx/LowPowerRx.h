@@ -0,0 +1,69 @@
+#ifndef WINTERHOME_LOWPOWERRX_H
+#define WINTERHOME_LOWPOWERRX_H
+
+#include <Arduino.h>
+#include <LoRa.h>
+
+// Прием с периодическим пробуждением радио. Между пробуждениями модуль спит,
+// при пробуждении выполняется CAD (channel activity detection) и полный прием
+// включается только если в эфире есть преамбула. Передатчик должен использовать
+// преамбулу не короче интервала пробуждения (см. RadioProfile).
+// Использует прерывание DIO0 модуля (по умолчанию D2).
+class LowPowerRx {
+    static const uint8_t STATE_SLEEP = 0;
+    static const uint8_t STATE_CAD = 1;
+    static const uint8_t STATE_RX = 2;
+
+    static const uint8_t CAD_IDLE = 0;
+    static const uint8_t CAD_FREE = 1;
+    static const uint8_t CAD_DETECTED = 2;
+
+    // Ток потребления SX1278 по datasheet, мкА.
+    static const uint16_t CURRENT_SLEEP = 1;
+    static const uint16_t CURRENT_RX = 10800;
+
+    static const uint8_t CAD_TIMEOUT = 50;
+
+    static volatile uint8_t cadResult;
+    static volatile int received;
+
+    static void onCadDone(bool detected);
+
+    static void onReceive(int packetSize);
+
+protected:
+    uint16_t wakeInterval;
+    uint16_t rxTimeout;
+
+    uint8_t state = STATE_SLEEP;
+    bool sleepPending = false;
+    unsigned long stateStart = 0;
+    unsigned long cadStart = 0;
+
+    unsigned long startedAt = 0;
+    unsigned long wakeups = 0;
+    unsigned long activeMillis = 0;
+    unsigned long activeMicros = 0;
+
+    void sleep();
+
+    void addActive(unsigned long us);
+
+public:
+    LowPowerRx(uint16_t wakeInterval, uint16_t rxTimeout);
+
+    void begin();
+
+    // Переводит радио в режим сна после передачи.
+    void resume();
+
+    // Возвращает размер принятого пакета или 0. Пакет нужно вычитать до следующего вызова.
+    int tick();
+
+    unsigned long getWakeups() const;
+
+    // Оценка среднего тока приемного тракта радио с момента begin(), мкА.
+    unsigned long getAverageCurrent() const;
+};
+
+#endif //WINTERHOME_LOWPOWERRX_H
@@ -0,0 +1,126 @@
+#include "RadioLink.h"
+
+#include <EEPROMex.h>
+#include <Link.h>
+
+RadioLink::RadioLink(const RadioProfile &profile, uint8_t nodeId, uint8_t peerId) : profile(profile) {
+    this->nodeId = nodeId;
+    this->peerId = peerId;
+}
+
+void RadioLink::begin() {
+    LoRa.begin(profile.frequency);
+    LoRa.setTxPower(profile.txPower);
+    LoRa.setSignalBandwidth(profile.bandwidth);
+    LoRa.setSpreadingFactor(profile.spreadingFactor);
+    LoRa.setCodingRate4(profile.codingRate);
+    LoRa.setPreambleLength(profile.preamble);
+    if (profile.crc) {
+        LoRa.enableCrc();
+    }
+    if (profile.wakeInterval) {
+        lpRx = new LowPowerRx(profile.wakeInterval, profile.wakeInterval * 2);
+        lpRx->begin();
+    } else {
+        LoRa.receive();
+    }
+}
+
+void RadioLink::beginAuth(const uint8_t *key) {
+    txLeaseAddress = EEPROM.getAddress(sizeof(long));
+    rxLeaseAddress = EEPROM.getAddress(sizeof(long));
+    if (key == nullptr) {
+        return;
+    }
+    auth = new Auth(key, nodeId, peerId);
+    synced = false;
+    auth->begin((uint32_t) EEPROM.readLong(txLeaseAddress), (uint32_t) EEPROM.readLong(rxLeaseAddress));
+    EEPROM.updateLong(txLeaseAddress, (long) auth->getTxLease());
+}
+
+void RadioLink::listen() {
+    if (lpRx) {
+        lpRx->resume();
+    } else {
+        LoRa.receive();
+    }
+}
+
+bool RadioLink::send(uint8_t priority, uint8_t type, const void *payload, uint8_t size) {
+    uint8_t frame[Frame::MAX_SIZE];
+    bool sync = auth && (!synced || auth->isSyncDue());
+    uint8_t length = Frame::encode(frame, type, payload, size, auth != nullptr, sync);
+    uint32_t airtime = profile.timeOnAir(length + Frame::trailerSize(frame));
+    if (!txScheduler.allow(priority, airtime, millis())) {
+        return false;
+    }
+    if (auth) {
+        length = auth->sign(frame, length, sync);
+        EEPROM.updateLong(txLeaseAddress, (long) auth->getTxLease());
+    }
+    while (LoRa.beginPacket() == 0) {
+        delay(100);
+    }
+    LoRa.write(frame, length);
+    LoRa.endPacket();
+    txScheduler.commit(airtime, millis());
+    listen();
+    return true;
+}
+
+int RadioLink::available() {
+    if (lpRx) {
+        return lpRx->tick();
+    }
+    return LoRa.parsePacket();
+}
+
+uint8_t RadioLink::read(uint8_t *packet, int packetSize) {
+    uint8_t length = 0;
+    if (packetSize <= Frame::MAX_SIZE) {
+        length = (uint8_t) LoRa.readBytes(packet, packetSize);
+    }
+    // packetSnr() - регистр SX127x, умноженный на 0.25, обратно переводится без потерь.
+    snr = (int8_t) (LoRa.packetSnr() * 4);
+    rssi = LoRa.packetRssi();
+    return length;
+}
+
+uint8_t RadioLink::check(const uint8_t *packet, uint8_t length) {
+    uint8_t type = Link::check(auth, packet, length);
+    if (auth && type != Frame::TYPE_INVALID) {
+        synced = true;
+        EEPROM.updateLong(rxLeaseAddress, (long) auth->getRxLease());
+    }
+    return type;
+}
+
+void RadioLink::requestSync() {
+    if (auth) {
+        auth->requestSync();
+    }
+}
+
+bool RadioLink::isAuthenticated() const {
+    return auth != nullptr;
+}
+
+bool RadioLink::isSynced() const {
+    return synced;
+}
+
+int8_t RadioLink::getSnr() const {
+    return snr;
+}
+
+int RadioLink::getRssi() const {
+    return rssi;
+}
+
+LowPowerRx *RadioLink::getLowPowerRx() const {
+    return lpRx;
+}
+
+TxScheduler &RadioLink::getScheduler() {
+    return txScheduler;
+}
@@ -0,0 +1,79 @@
+#ifndef WINTERHOME_RADIOLINK_H
+#define WINTERHOME_RADIOLINK_H
+
+#include <Arduino.h>
+#include <LoRa.h>
+#include <Auth.h>
+#include <Frame.h>
+#include <LowPowerRx.h>
+#include <RadioProfile.h>
+#include <TxScheduler.h>
+
+// Радиоканал блока: настройка LoRa по профилю радио, прием (постоянный или с
+// пробуждением по CAD, см. LowPowerRx), бюджет эфира и аутентификация кадров
+// со счетчиками в EEPROM. Один и тот же для домашнего и удаленного блока.
+class RadioLink {
+    const RadioProfile &profile;
+    uint8_t nodeId;
+    uint8_t peerId;
+
+    LowPowerRx *lpRx = nullptr;
+
+    Auth *auth = nullptr;
+    int txLeaseAddress = 0;
+    int rxLeaseAddress = 0;
+    // После включения собеседник не примет наши кадры, пока не получит кадр синхронизации,
+    // а единственный такой кадр может потеряться. Поэтому синхронизацией подписывается каждый
+    // кадр, пока не принят кадр собеседника: он отвечает синхронизацией на нашу.
+    bool synced = true;
+
+    // Пятая часть бюджета эфира резервируется для команд и ответов.
+    TxScheduler txScheduler{RADIO_DUTY_CYCLE_PERCENT, 20};
+
+    // SNR последнего кадра в четвертях дБ, как в регистре SX127x.
+    int8_t snr = 0;
+    int rssi = 0;
+
+    void listen();
+
+public:
+    // Профиль передается скетчем (обычно RADIO), библиотека от выбора профиля не зависит.
+    RadioLink(const RadioProfile &profile, uint8_t nodeId, uint8_t peerId);
+
+    void begin();
+
+    // Адреса счетчиков в EEPROM резервируются и без ключа, чтобы раскладка не зависела
+    // от аутентификации. key == nullptr - аутентификация выключена.
+    void beginAuth(const uint8_t *key);
+
+    // Передает кадр, если позволяет бюджет эфира. Возвращает false, если кадр не передан.
+    bool send(uint8_t priority, uint8_t type, const void *payload, uint8_t size);
+
+    // Размер принятого пакета или 0.
+    int available();
+
+    // Вычитывает принятый пакет размера packetSize в packet (не меньше Frame::MAX_SIZE байт),
+    // запоминает его SNR и RSSI. Чужие длинные пакеты отбрасываются без чтения FIFO, тогда 0.
+    uint8_t read(uint8_t *packet, int packetSize);
+
+    // Проверяет формат и подпись кадра, возвращает его тип или Frame::TYPE_INVALID.
+    uint8_t check(const uint8_t *packet, uint8_t length);
+
+    // Подписать следующий кадр как кадр синхронизации.
+    void requestSync();
+
+    bool isAuthenticated() const;
+
+    // Принят ли с включения хоть один кадр собеседника. Без аутентификации всегда true.
+    bool isSynced() const;
+
+    int8_t getSnr() const;
+
+    int getRssi() const;
+
+    LowPowerRx *getLowPowerRx() const;
+
+    TxScheduler &getScheduler();
+};
+
+#endif //WINTERHOME_RADIOLINK_H
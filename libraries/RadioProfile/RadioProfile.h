@@ -0,0 +1,106 @@
+#ifndef WINTERHOME_RADIOPROFILE_H
+#define WINTERHOME_RADIOPROFILE_H
+
+#include <stdint.h>
+#include <Frame.h>
+
+// Настройки радио, общие для домашнего и удаленного блока. Время в эфире
+// считается при компиляции по формуле из datasheet SX1276/77/78 (explicit header).
+struct RadioProfile {
+    long frequency;
+    uint8_t spreadingFactor;
+    long bandwidth;
+    // Знаменатель coding rate 4/5..4/8.
+    uint8_t codingRate;
+    uint8_t txPower;
+    uint16_t preamble;
+    bool crc;
+    // Интервал пробуждения приемника в режиме CAD, 0 - постоянный прием.
+    uint16_t wakeInterval;
+
+    // Длительность символа, мкс.
+    constexpr uint32_t symbolMicros() const
+    {
+        return (uint32_t) ((1000000ULL << spreadingFactor) / bandwidth);
+    }
+
+    // Low data rate optimize, библиотека LoRa включает его так же.
+    constexpr bool lowDataRate() const
+    {
+        return symbolMicros() > 16000;
+    }
+
+    constexpr int32_t payloadBits(uint8_t length) const
+    {
+        return 8L * length - 4L * spreadingFactor + 28 + (crc ? 16 : 0);
+    }
+
+    constexpr int32_t payloadBlockBits() const
+    {
+        return 4L * (spreadingFactor - (lowDataRate() ? 2 : 0));
+    }
+
+    constexpr uint32_t payloadSymbols(uint8_t length) const
+    {
+        return 8 + (payloadBits(length) > 0
+                    ? (uint32_t) ((payloadBits(length) + payloadBlockBits() - 1) / payloadBlockBits()) * codingRate
+                    : 0);
+    }
+
+    // Время в эфире кадра длиной length байт, мкс.
+    constexpr uint32_t timeOnAir(uint8_t length) const
+    {
+        return (uint32_t) ((4ULL * preamble + 17 + 4ULL * payloadSymbols(length)) * (1000000ULL << spreadingFactor)
+                           / bandwidth / 4);
+    }
+};
+
+// Длина преамбулы в символах, перекрывающая интервал пробуждения приемника
+// с запасом на CAD, на включение приема из loop() после него (до ~20 мс при SF8)
+// и на захват преамбулы приемником.
+constexpr uint16_t radioWakePreamble(uint8_t sf, long bw, uint16_t wakeInterval)
+{
+    return (uint16_t) (wakeInterval * 1000ULL / ((1000000ULL << sf) / bw) + 24);
+}
+
+constexpr RadioProfile RADIO_433_SF8 = {433000000L, 8, 125000L, 5, 16, 8, true, 0};
+constexpr RadioProfile RADIO_433_SF8_LOW_POWER = {
+        433000000L, 8, 125000L, 5, 16, radioWakePreamble(8, 125000L, 500), true, 500
+};
+
+// Профиль, с которым собираются оба блока. Прием с пробуждением по CAD включается
+// флагом сборки -DWINTERHOME_RADIO_LOW_POWER (build_flags обоих блоков).
+#ifdef WINTERHOME_RADIO_LOW_POWER
+constexpr RadioProfile RADIO = RADIO_433_SF8_LOW_POWER;
+#else
+constexpr RadioProfile RADIO = RADIO_433_SF8;
+#endif
+
+// Периодичность телеметрии удаленного блока, мс. Длинная преамбула режима CAD
+// увеличивает время в эфире, поэтому телеметрия отправляется реже.
+const uint16_t RADIO_TELEMETRY_INTERVAL = RADIO.wakeInterval ? 30000 : 10000;
+
+// Ограничение ETSI EN 300 220 для 433.05-434.79 МГц: 10% времени в эфире.
+const uint8_t RADIO_DUTY_CYCLE_PERCENT = 10;
+
+// Максимальные длины кадров с трейлером аутентификации (у кадра синхронизации он длиннее).
+const uint8_t RADIO_FRAME_COMMAND = Frame::HEADER_SIZE + Frame::SYNC_TRAILER_SIZE;
+const uint8_t RADIO_FRAME_CONFIG = Frame::HEADER_SIZE + sizeof(Frame::Config) + Frame::SYNC_TRAILER_SIZE;
+const uint8_t RADIO_FRAME_TELEMETRY = Frame::HEADER_SIZE + sizeof(Frame::Telemetry) + Frame::SYNC_TRAILER_SIZE;
+
+constexpr uint32_t RADIO_AIRTIME_COMMAND = RADIO.timeOnAir(RADIO_FRAME_COMMAND);
+constexpr uint32_t RADIO_AIRTIME_CONFIG = RADIO.timeOnAir(RADIO_FRAME_CONFIG);
+constexpr uint32_t RADIO_AIRTIME_TELEMETRY = RADIO.timeOnAir(RADIO_FRAME_TELEMETRY);
+
+static_assert(RADIO_FRAME_CONFIG <= Frame::MAX_SIZE && RADIO_FRAME_TELEMETRY <= Frame::MAX_SIZE,
+              "frame does not fit Frame::MAX_SIZE");
+static_assert(RADIO.wakeInterval == 0 || RADIO.preamble >= radioWakePreamble(RADIO.spreadingFactor, RADIO.bandwidth,
+                                                                              RADIO.wakeInterval),
+              "preamble is shorter than the CAD wake interval");
+// Удаленный блок на каждый период телеметрии может дополнительно ответить
+// на команду телеметрией и подтверждением настроек.
+static_assert((RADIO_AIRTIME_TELEMETRY * 2 + RADIO_AIRTIME_CONFIG) * 100ULL
+              <= RADIO_TELEMETRY_INTERVAL * 1000ULL * RADIO_DUTY_CYCLE_PERCENT,
+              "telemetry cadence exceeds the duty-cycle limit");
+
+#endif //WINTERHOME_RADIOPROFILE_H
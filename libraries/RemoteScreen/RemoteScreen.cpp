@@ -0,0 +1,22 @@
+#include "RemoteScreen.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <Format.h>
+
+void RemoteScreen::build(int8_t quarterDb, uint8_t percent, Centi humidity, Centi temperature) {
+    snr[0] = 0;
+    Format::snr(snr, quarterDb);
+    strcat(snr, "dB");
+
+    for (int i = 0; i < 12; ++i) {
+        bar[i] = i * 90 < percent * 12 ? '#' : ' ';
+    }
+    sprintf(bar + 12, ":%2u%%", percent);
+
+    strcpy(hum, "H:");
+    Format::humidity(hum, humidity);
+
+    strcpy(temp, "T:");
+    Format::temperature(temp, temperature, true);
+}
@@ -0,0 +1,22 @@
+#ifndef WINTERHOME_REMOTESCREEN_H
+#define WINTERHOME_REMOTESCREEN_H
+
+#include <stdint.h>
+#include <Fixed.h>
+
+// Строки основного экрана удаленного блока (STATE_DISPLAY). Их собирает
+// RemoteController::render() перед выводом на OLED, tools/benchmark меряет
+// ту же сборку без дисплея.
+struct RemoteScreen {
+    // "-5dB"
+    char snr[10];
+    // Положение клапана: 12 делений '#' и "%2u%", "######      :45%".
+    char bar[18];
+    char hum[18];
+    char temp[18];
+
+    // quarterDb - SNR в четвертях дБ, percent - открытие клапана 0..90.
+    void build(int8_t quarterDb, uint8_t percent, Centi humidity, Centi temperature);
+};
+
+#endif //WINTERHOME_REMOTESCREEN_H
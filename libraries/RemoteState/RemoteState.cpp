@@ -0,0 +1,13 @@
+#include "RemoteState.h"
+
+void RemoteState::apply(const Frame::Telemetry &t) {
+    errCode = t.errCode;
+    temp = Centi::fromRaw(t.temp);
+    hum = Centi::fromRaw(t.hum);
+    angle = t.angle;
+    r1 = t.r1 != 0;
+    r2 = t.r2 != 0;
+    tempMin = Centi::fromRaw(t.tempMin);
+    tempMax = Centi::fromRaw(t.tempMax);
+    tempMean = Centi::fromRaw(t.tempMean);
+}
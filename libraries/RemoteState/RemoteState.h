@@ -0,0 +1,25 @@
+#ifndef WINTERHOME_REMOTESTATE_H
+#define WINTERHOME_REMOTESTATE_H
+
+#include <stdint.h>
+#include <Frame.h>
+#include <Fixed.h>
+
+// Состояние удаленного блока, которое домашний восстанавливает из кадров
+// телеметрии. Тот же разбор используют HomeController и tools/capreplay.
+struct RemoteState {
+    uint8_t errCode = 0;
+    Centi temp;
+    Centi hum;
+    int16_t angle = 0;
+    bool r1 = false;
+    bool r2 = false;
+    // Минимум, максимум и среднее температуры за период телеметрии.
+    Centi tempMin;
+    Centi tempMax;
+    Centi tempMean;
+
+    void apply(const Frame::Telemetry &t);
+};
+
+#endif //WINTERHOME_REMOTESTATE_H
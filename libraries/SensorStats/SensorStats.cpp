@@ -0,0 +1,101 @@
+#include "SensorStats.h"
+
+SensorStats::SensorStats(uint8_t alphaShift) {
+    this->alphaShift = alphaShift;
+}
+
+int16_t SensorStats::median() const {
+    if (historySize < MEDIAN_SIZE) {
+        return history[(historyNext + MEDIAN_SIZE - 1) % MEDIAN_SIZE];
+    }
+    int16_t a = history[0];
+    int16_t b = history[1];
+    int16_t c = history[2];
+    if (a > b) {
+        int16_t t = a;
+        a = b;
+        b = t;
+    }
+    // a <= b, медиана - b, ограниченное c сверху и a снизу.
+    if (c < b) {
+        return c > a ? c : a;
+    }
+    return b;
+}
+
+Centi SensorStats::add(Centi sample) {
+    history[historyNext] = sample.toRaw();
+    historyNext = (historyNext + 1) % MEDIAN_SIZE;
+    if (historySize < MEDIAN_SIZE) {
+        historySize++;
+    }
+
+    // Замер без соседей не проверить на выброс: в EWMA и окно он попадет только в медиане.
+    if (!isReady()) {
+        return getAverage();
+    }
+    int16_t value = median();
+    int32_t scaled = (int32_t) value * (1 << EWMA_FRACTION);
+    if (!seeded) {
+        ewma = scaled;
+        seeded = true;
+    } else {
+        ewma += (scaled - ewma) >> alphaShift;
+    }
+
+    if (windowSamples == 0 || value < windowMin) {
+        windowMin = value;
+    }
+    if (windowSamples == 0 || value > windowMax) {
+        windowMax = value;
+    }
+    windowSum += value;
+    windowSamples++;
+
+    return getAverage();
+}
+
+bool SensorStats::isEmpty() const {
+    return historySize == 0;
+}
+
+bool SensorStats::isReady() const {
+    return historySize == MEDIAN_SIZE;
+}
+
+Centi SensorStats::getFiltered() const {
+    return Centi::fromRaw(historySize ? median() : 0);
+}
+
+Centi SensorStats::getAverage() const {
+    if (!seeded) {
+        return getFiltered();
+    }
+    // Сдвиг с округлением к ближайшему.
+    return Centi::fromRaw((int16_t) ((ewma + (1 << (EWMA_FRACTION - 1))) >> EWMA_FRACTION));
+}
+
+Centi SensorStats::getMin() const {
+    return windowSamples ? Centi::fromRaw(windowMin) : getAverage();
+}
+
+Centi SensorStats::getMax() const {
+    return windowSamples ? Centi::fromRaw(windowMax) : getAverage();
+}
+
+Centi SensorStats::getMean() const {
+    if (!windowSamples) {
+        return getAverage();
+    }
+    int32_t half = windowSamples / 2;
+    return Centi::fromRaw((int16_t) ((windowSum < 0 ? windowSum - half : windowSum + half) / windowSamples));
+}
+
+uint16_t SensorStats::getSamples() const {
+    return windowSamples;
+}
+
+void SensorStats::resetWindow() {
+    windowSum = 0;
+    windowSamples = 0;
+}
@@ -0,0 +1,63 @@
+#ifndef WINTERHOME_SENSORSTATS_H
+#define WINTERHOME_SENSORSTATS_H
+
+#include <stdint.h>
+#include <Fixed.h>
+
+// Потоковая обработка замеров датчика без хранения истории:
+// медиана последних MEDIAN_SIZE замеров отсекает одиночные выбросы, EWMA
+// сглаживает вход регулятора, min/max/mean копятся за окно отчета до resetWindow().
+// Пока медиане не хватает замеров, выброс в них не отсекается, поэтому EWMA и
+// окно начинаются с первой полной медианы, а до isReady() значения только для показа.
+class SensorStats {
+    static const uint8_t MEDIAN_SIZE = 3;
+    // Дробные разряды EWMA, чтобы малые изменения не терялись при сдвиге.
+    static const uint8_t EWMA_FRACTION = 4;
+
+    uint8_t alphaShift;
+
+    int16_t history[MEDIAN_SIZE]{};
+    uint8_t historySize = 0;
+    uint8_t historyNext = 0;
+
+    int32_t ewma = 0;
+    bool seeded = false;
+
+    int16_t windowMin = 0;
+    int16_t windowMax = 0;
+    int32_t windowSum = 0;
+    uint16_t windowSamples = 0;
+
+    int16_t median() const;
+
+public:
+    // Вес нового значения в EWMA 1/2^alphaShift.
+    explicit SensorStats(uint8_t alphaShift);
+
+    // Добавляет замер и возвращает сглаженное значение.
+    Centi add(Centi sample);
+
+    bool isEmpty() const;
+
+    // Набрано MEDIAN_SIZE замеров: среднее и статистика окна годятся для регулятора и телеметрии.
+    bool isReady() const;
+
+    // Медиана последних замеров.
+    Centi getFiltered() const;
+
+    // Экспоненциальное среднее медиан, до isReady() - последний замер.
+    Centi getAverage() const;
+
+    // Статистика медиан с начала окна, при пустом окне - текущее среднее.
+    Centi getMin() const;
+
+    Centi getMax() const;
+
+    Centi getMean() const;
+
+    uint16_t getSamples() const;
+
+    void resetWindow();
+};
+
+#endif //WINTERHOME_SENSORSTATS_H
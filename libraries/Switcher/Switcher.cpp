@@ -9,12 +9,11 @@ Switcher::Switcher(uint8_t swPin) {
 }
 
 int Switcher::getIndex() {
-    uint8_t i = 0;
-    do {
+    for (uint8_t i = 0; i < MAX; i++) {
         if (arr[i].cb == NULL) {
             return i;
         }
-    }  while (i++ <= MAX );
+    }
     return -1;
 }
 
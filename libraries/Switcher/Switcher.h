@@ -28,7 +28,7 @@ public:
 
     bool isPressed();
 
-    void addHandler(void (*cb)(), unsigned int pressTime);
+    void addHandler(void (*cb)(), uint16_t pressTime);
 
     void tick();
 };
@@ -4,12 +4,11 @@
 Task::Task() = default;
 
 int Task::getIndex() {
-    uint8_t i = 0;
-    do {
+    for (uint8_t i = 0; i < MAX; i++) {
         if (a[i].cb == NULL) {
             return i;
         }
-    }  while (i++ <= MAX );
+    }
     return -1;
 }
 
@@ -33,7 +32,7 @@ void Task::one(void (*cb)(), uint16_t t) {
 
 void Task::tick() {
     unsigned long m = millis();
-    for (int i = 0; i <= MAX; i++) {
+    for (uint8_t i = 0; i < MAX; i++) {
         if (a[i].cb != NULL && m >= (a[i].last + a[i].timeout)) {
             if (a[i].type == TYPE_EACH) {
                 a[i].cb();
@@ -49,12 +48,10 @@ void Task::tick() {
 }
 
 void Task::replace(void (*cb)(), uint16_t t) {
-    uint8_t i = 0;
-    do {
+    for (uint8_t i = 0; i < MAX; i++) {
         if (a[i].cb == cb) {
-            a[i].cb = cb;
             a[i].last = millis();
             a[i].timeout = t;
         }
-    }  while (i++ <= MAX );
+    }
 }
@@ -0,0 +1,138 @@
+#include "TrendBuffer.h"
+
+TrendBuffer::TrendBuffer() {
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+        minimum[i] = EMPTY;
+        maximum[i] = EMPTY;
+    }
+}
+
+uint8_t TrendBuffer::quantize(Centi value) {
+    int32_t q = ((int32_t) value.toRaw() - QUANT_MIN) / QUANT_STEP;
+    if (q < 0) {
+        return 0;
+    }
+    return q >= EMPTY ? EMPTY - 1 : (uint8_t) q;
+}
+
+Centi TrendBuffer::dequantize(uint8_t value) {
+    return Centi::fromRaw((int16_t) (QUANT_MIN + value * QUANT_STEP));
+}
+
+uint8_t TrendBuffer::index(uint8_t age) const {
+    return (uint8_t) ((bucket - age) % BUCKETS);
+}
+
+void TrendBuffer::clear(uint8_t i) {
+    minimum[i] = EMPTY;
+    maximum[i] = EMPTY;
+    duty[i] = 0;
+}
+
+void TrendBuffer::rescan() {
+    plotMin = EMPTY;
+    plotMax = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+        if (minimum[i] == EMPTY) {
+            continue;
+        }
+        if (minimum[i] < plotMin) {
+            plotMin = minimum[i];
+        }
+        if (maximum[i] > plotMax) {
+            plotMax = maximum[i];
+        }
+    }
+}
+
+void TrendBuffer::advance(unsigned long now) {
+    uint32_t current = now / BUCKET_MS;
+    if (current == bucket) {
+        return;
+    }
+    // millis() переполняется раз в 49 дней, тогда история начинается заново.
+    if (current < bucket || current - bucket >= BUCKETS) {
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            clear(i);
+        }
+        plotMin = EMPTY;
+        plotMax = 0;
+    } else {
+        bool extreme = false;
+        while (bucket != current) {
+            bucket++;
+            uint8_t i = (uint8_t) (bucket % BUCKETS);
+            if (minimum[i] != EMPTY && (minimum[i] == plotMin || maximum[i] == plotMax)) {
+                extreme = true;
+            }
+            clear(i);
+        }
+        if (extreme) {
+            rescan();
+        }
+    }
+    bucket = current;
+    samples = 0;
+    r1Samples = 0;
+    r2Samples = 0;
+}
+
+void TrendBuffer::add(unsigned long now, Centi low, Centi high, bool r1, bool r2) {
+    advance(now);
+    uint8_t i = index(0);
+
+    uint8_t qLow = quantize(low);
+    uint8_t qHigh = quantize(high);
+    if (minimum[i] == EMPTY || qLow < minimum[i]) {
+        minimum[i] = qLow;
+    }
+    if (maximum[i] == EMPTY || qHigh > maximum[i]) {
+        maximum[i] = qHigh;
+    }
+    if (qLow < plotMin) {
+        plotMin = qLow;
+    }
+    if (qHigh > plotMax) {
+        plotMax = qHigh;
+    }
+
+    // Доля работы считается по числу кадров, после 255 кадров в интервале не меняется.
+    if (samples == 0xFF) {
+        return;
+    }
+    samples++;
+    r1Samples += r1 ? 1 : 0;
+    r2Samples += r2 ? 1 : 0;
+    uint8_t d1 = (uint8_t) ((r1Samples * DUTY_MAX + samples / 2) / samples);
+    uint8_t d2 = (uint8_t) ((r2Samples * DUTY_MAX + samples / 2) / samples);
+    duty[i] = (uint8_t) ((d1 << 4) | d2);
+}
+
+bool TrendBuffer::isEmpty(uint8_t age) const {
+    return minimum[index(age)] == EMPTY;
+}
+
+uint8_t TrendBuffer::getMin(uint8_t age) const {
+    return minimum[index(age)];
+}
+
+uint8_t TrendBuffer::getMax(uint8_t age) const {
+    return maximum[index(age)];
+}
+
+uint8_t TrendBuffer::getDuty(uint8_t age, uint8_t relay) const {
+    uint8_t d = duty[index(age)];
+    return relay == 1 ? d >> 4 : d & 0x0F;
+}
+
+bool TrendBuffer::hasData() const {
+    return plotMin != EMPTY;
+}
+
+uint8_t TrendBuffer::getPlotMin() const {
+    return plotMin;
+}
+
+uint8_t TrendBuffer::getPlotMax() const {
+    return plotMax;
+}
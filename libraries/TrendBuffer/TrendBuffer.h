@@ -0,0 +1,75 @@
+#ifndef WINTERHOME_TRENDBUFFER_H
+#define WINTERHOME_TRENDBUFFER_H
+
+#include <stdint.h>
+#include <Fixed.h>
+
+// История температуры и работы реле за WINDOW для графика на домашнем блоке.
+// Окно разбито на BUCKETS интервалов, в каждом по байту: минимум и максимум
+// температуры, квантованные с шагом QUANT_STEP, и доли работы R1 и R2 по 4 бита.
+// Границы графика обновляются при каждом замере, буфер пересматривается только
+// когда из окна уходит интервал с крайним значением.
+class TrendBuffer {
+public:
+    static const uint8_t BUCKETS = 64;
+    static const uint32_t BUCKET_MS = 1350000;
+    static const uint32_t WINDOW = BUCKET_MS * BUCKETS;
+
+    // Квантованная температура: 0 соответствует QUANT_MIN, EMPTY - нет данных.
+    static const uint8_t EMPTY = 0xFF;
+    static const int16_t QUANT_MIN = -4000;
+    static const int16_t QUANT_STEP = 50;
+
+    static const uint8_t DUTY_MAX = 15;
+
+protected:
+    uint8_t minimum[BUCKETS];
+    uint8_t maximum[BUCKETS];
+    uint8_t duty[BUCKETS]{};
+
+    uint32_t bucket = 0;
+    uint8_t samples = 0;
+    uint8_t r1Samples = 0;
+    uint8_t r2Samples = 0;
+
+    uint8_t plotMin = EMPTY;
+    uint8_t plotMax = 0;
+
+    uint8_t index(uint8_t age) const;
+
+    void clear(uint8_t i);
+
+    void rescan();
+
+public:
+    TrendBuffer();
+
+    static uint8_t quantize(Centi value);
+
+    static Centi dequantize(uint8_t value);
+
+    // Сдвигает окно к моменту now, мс.
+    void advance(unsigned long now);
+
+    // Учитывает телеметрию: диапазон температуры за период и состояние реле.
+    void add(unsigned long now, Centi low, Centi high, bool r1, bool r2);
+
+    // Интервалы адресуются возрастом: 0 - текущий, BUCKETS - 1 - самый старый.
+    bool isEmpty(uint8_t age) const;
+
+    uint8_t getMin(uint8_t age) const;
+
+    uint8_t getMax(uint8_t age) const;
+
+    // Доля работы реле в интервале, 0..DUTY_MAX.
+    uint8_t getDuty(uint8_t age, uint8_t relay) const;
+
+    bool hasData() const;
+
+    // Границы всех непустых интервалов, квантованные.
+    uint8_t getPlotMin() const;
+
+    uint8_t getPlotMax() const;
+};
+
+#endif //WINTERHOME_TRENDBUFFER_H
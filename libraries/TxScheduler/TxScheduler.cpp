@@ -0,0 +1,52 @@
+#include "TxScheduler.h"
+
+TxScheduler::TxScheduler(uint8_t dutyPercent, uint8_t reservePercent) {
+    budgetMs = WINDOW / 100 * dutyPercent;
+    reserveMs = budgetMs / 100 * reservePercent;
+}
+
+void TxScheduler::advance(unsigned long now) {
+    uint32_t current = now / BUCKET_MS;
+    // millis() переполняется раз в 49 дней, тогда окно начинается заново.
+    if (current < bucket || current - bucket >= BUCKETS) {
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            used[i] = 0;
+        }
+    } else {
+        while (bucket != current) {
+            bucket++;
+            used[bucket % BUCKETS] = 0;
+        }
+    }
+    bucket = current;
+}
+
+uint32_t TxScheduler::usedMs() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++) {
+        total += used[i];
+    }
+    return total;
+}
+
+bool TxScheduler::allow(uint8_t priority, uint32_t airtime, unsigned long now) {
+    advance(now);
+    uint32_t limit = priority == PRIORITY_LOW ? budgetMs - reserveMs : budgetMs;
+    return usedMs() + (airtime + 999) / 1000 <= limit;
+}
+
+void TxScheduler::commit(uint32_t airtime, unsigned long now) {
+    advance(now);
+    uint32_t total = used[bucket % BUCKETS] + (airtime + 999) / 1000;
+    used[bucket % BUCKETS] = total > 0xFFFF ? 0xFFFF : (uint16_t) total;
+}
+
+uint32_t TxScheduler::remaining(unsigned long now) {
+    advance(now);
+    uint32_t total = usedMs();
+    return total < budgetMs ? budgetMs - total : 0;
+}
+
+uint32_t TxScheduler::getBudget() const {
+    return budgetMs;
+}
@@ -0,0 +1,46 @@
+#ifndef WINTERHOME_TXSCHEDULER_H
+#define WINTERHOME_TXSCHEDULER_H
+
+#include <stdint.h>
+
+// Учет времени в эфире в скользящем окне WINDOW и допуск кадров по приоритету.
+// Окно разбито на BUCKETS интервалов, в каждом хранится занятое время в мс.
+// Кадрам с низким приоритетом (периодическая телеметрия) оставляется только
+// часть бюджета, остаток резервируется для команд и ответов на них.
+class TxScheduler {
+    static const uint8_t BUCKETS = 12;
+    static const uint32_t BUCKET_MS = 300000;
+
+    uint16_t used[BUCKETS]{};
+    uint32_t bucket = 0;
+    uint32_t budgetMs;
+    uint32_t reserveMs;
+
+    void advance(unsigned long now);
+
+    uint32_t usedMs() const;
+
+public:
+    static const uint32_t WINDOW = BUCKET_MS * BUCKETS;
+
+    static const uint8_t PRIORITY_ACK = 0;
+    static const uint8_t PRIORITY_NORMAL = 1;
+    static const uint8_t PRIORITY_LOW = 2;
+
+    // dutyPercent - допустимая доля времени в эфире, reservePercent - доля бюджета,
+    // недоступная кадрам PRIORITY_LOW.
+    TxScheduler(uint8_t dutyPercent, uint8_t reservePercent);
+
+    // Можно ли сейчас передать кадр длительностью airtime мкс.
+    bool allow(uint8_t priority, uint32_t airtime, unsigned long now);
+
+    // Учитывает переданный кадр.
+    void commit(uint32_t airtime, unsigned long now);
+
+    // Оставшийся бюджет в текущем окне, мс.
+    uint32_t remaining(unsigned long now);
+
+    uint32_t getBudget() const;
+};
+
+#endif //WINTERHOME_TXSCHEDULER_H
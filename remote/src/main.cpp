@@ -7,9 +7,15 @@
 #include <Wire.h>
 #include <dht_nonblocking.h>
 #include <Task.h>
-#include <RotaryEncoder.h>
+#include <AcceleratedEncoder.h>
 #include <EEPROMex.h>
 #include <Button.h>
+#include <LowPowerRx.h>
+#include <Frame.h>
+#include <RadioLink.h>
+#include <Fixed.h>
+#include <SensorStats.h>
+#include <RemoteScreen.h>
 
 const uint8_t OLED_CS = 8;
 const uint8_t OLED_DC = 6;
@@ -20,15 +26,44 @@ const uint8_t DHT22 = 4;
 
 const uint8_t R1 = A0;
 const uint8_t R2 = A1;
+// Кадр по первым замерам, пока медиана не набрана: значения не фильтрованы,
+// но это не ошибка датчика.
+const uint8_t ERR_WARMUP = 2;
+
+const uint8_t SRV_SPEED = 10;
+
+// Допустимые уставка температуры и пороги реле.
+constexpr Centi TEMP_MIN = Centi::fromInt(-20);
+constexpr Centi TEMP_MAX = Centi::fromInt(40);
+constexpr Centi THRESHOLD_MIN = Centi::fromFraction(1, 10);
+constexpr Centi THRESHOLD_MAX = Centi::fromInt(10);
+
+const uint8_t NODE_ID = 'R';
+const uint8_t PEER_ID = 'H';
+
+// Аутентификация кадров включается общим для обоих блоков ключом в include/AuthKey.h
+// (см. libraries/Auth/AuthKey.h.example).
+#if __has_include(<AuthKey.h>)
+#include <AuthKey.h>
+const bool AUTH = true;
+#else
+const uint8_t AUTH_KEY[16] = {};
+const bool AUTH = false;
+#endif
 
 class Controller : public HandlerInterface
 {
 
 protected:
-    static const uint8_t CMD_UP = 1;
-    static const uint8_t CMD_DOWN = 2;
+    static const uint8_t CFG_ANGLE = 1;
+    static const uint8_t CFG_TEMP = 2;
+    static const uint8_t CFG_R1 = 4;
+    static const uint8_t CFG_R2 = 8;
 
-    float snr = 0;
+    RadioLink radio{RADIO, NODE_ID, PEER_ID};
+
+    // Принятые пакеты, не прошедшие проверку формата или подписи.
+    unsigned long dropped = 0;
 
     union Int {
         int i = 0;
@@ -37,13 +72,8 @@ protected:
 
     Int angle;
 
-    union Float {
-        float f = 0;
-        uint8_t b[sizeof(float)];
-    };
-
-    Float currentTemp;
-    Float currentHum;
+    Centi currentTemp;
+    Centi currentHum;
 
     virtual bool relayIsOn(uint8_t pin)= 0;
 
@@ -51,35 +81,82 @@ public:
 
     Controller(uint8_t cs, uint8_t dc, uint8_t reset)
     {
-        LoRa.begin(433E6);
-        LoRa.setTxPower(16);
-        LoRa.setSpreadingFactor(8);
-        LoRa.enableCrc();
+        radio.begin();
     }
 
     virtual void render() = 0;
 };
 
+AcceleratedEncoder encoder(A2, A3);
+
+ISR(PCINT1_vect)
+{
+    encoder.tick();
+}
+
 class RemoteController : public Controller
 {
+    // Окно объединения команд движения клапана.
+    const uint16_t MOTION_WINDOW = 300;
+    // Максимальная задержка от первой команды пачки до начала движения.
+    const uint16_t MOTION_MAX_DELAY = 1500;
+    // Пауза перед повтором ответа на команду, которому не хватило бюджета эфира.
+    const uint16_t ACK_RETRY = 1000;
+    // Сколько состояние реле должно продержаться, чтобы его стоило записать в EEPROM.
+    // Реле переключаются тысячи раз в неделю, запись на каждое переключение
+    // выработала бы ресурс ячейки (100000 циклов) за несколько месяцев.
+    const uint32_t RELAY_SAVE_DELAY = 600000;
+
+    // Этапы запуска, по одному устройству за вызов tick().
+    static const uint8_t BOOT_STORAGE = 0;
+    static const uint8_t BOOT_SENSOR = 1;
+    static const uint8_t BOOT_SERVO = 2;
+    static const uint8_t BOOT_DISPLAY = 3;
+    static const uint8_t BOOT_ENCODER = 4;
+    static const uint8_t BOOT_DONE = 5;
+
 protected:
-    U8X8_SH1106_128X64_NONAME_4W_HW_SPI *oled;
-    DHT_nonblocking *dht;
-    ServoEasing *srv;
-    RotaryEncoder *encoder;
+    U8X8_SH1106_128X64_NONAME_4W_HW_SPI *oled = nullptr;
+    DHT_nonblocking *dht = nullptr;
+    ServoEasing *srv = nullptr;
+
+    uint8_t oledCs;
+    uint8_t oledDc;
+    uint8_t oledReset;
+    uint8_t bootStage = BOOT_STORAGE;
+    // Время от включения до первого переданного кадра телеметрии (любого, в том числе
+    // ERR_WARMUP), 0 - кадр еще не отправлен.
+    unsigned long firstFrameTime = 0;
 
     uint8_t relayMode = HIGH;
     bool tempReading = false;
-    long prevPosition = 0;
-    float r1Threshold = 0.5;
-    float r2Threshold = 1;
-    float requiredTemp = 5;
+    // Вход регулятора и телеметрии - сглаженные замеры, см. SensorStats.
+    SensorStats tempStats{2};
+    SensorStats humStats{2};
+
+    Centi r1Threshold = Centi::fromFraction(5, 10);
+    Centi r2Threshold = Centi::fromInt(1);
+    Centi requiredTemp = Centi::fromInt(5);
     uint8_t r1ThresholdAddress;
     uint8_t r2ThresholdAddress;
     uint8_t requiredTempAddress;
     uint8_t angleAddress;
+    uint8_t relayStateAddress;
+    bool relaySavePending = false;
+    unsigned long relayChangedAt = 0;
     uint8_t displayState = STATE_INIT;
 
+    int motionTarget = 0;
+    bool motionPending = false;
+    bool motionSettling = false;
+    bool reportOnSettle = false;
+    bool configAckPending = false;
+    uint8_t configAccepted = 0;
+    // Время последнего ответа, отложенного из-за бюджета эфира.
+    unsigned long ackDeniedAt = 0;
+    unsigned long motionFirst = 0;
+    unsigned long motionLast = 0;
+
     void displayRelay(uint8_t relayPin)
     {
         char tempOutput[10]{};
@@ -107,6 +184,8 @@ protected:
         bool change = !relayIsOn(pin);
         digitalWrite(pin, relayMode ? HIGH : LOW);
         if (change) {
+            relaySavePending = true;
+            relayChangedAt = millis();
             render();
         }
     }
@@ -116,15 +195,113 @@ protected:
         bool change = relayIsOn(pin);
         digitalWrite(pin, relayMode ? LOW : HIGH);
         if (change) {
+            relaySavePending = true;
+            relayChangedAt = millis();
             render();
         }
     }
 
+    // Состояние реле сохраняется, чтобы после перезапуска не сбрасывать нагрев до первого замера.
+    // Пишется только продержавшееся RELAY_SAVE_DELAY состояние: не чаще раза в 10 минут.
+    void saveRelays()
+    {
+        if (!relaySavePending || (millis() - relayChangedAt) < RELAY_SAVE_DELAY) {
+            return;
+        }
+        relaySavePending = false;
+        EEPROM.updateByte(relayStateAddress, (uint8_t) ((relayIsOn(R1) ? 1 : 0) | (relayIsOn(R2) ? 2 : 0)));
+    }
+
+    void restoreRelays()
+    {
+        uint8_t state = EEPROM.readByte(relayStateAddress);
+        // Чистая EEPROM читается как 0xFF.
+        if (state == 0xFF) {
+            state = 0;
+        }
+        pinMode(R1, OUTPUT);
+        pinMode(R2, OUTPUT);
+        digitalWrite(R1, (state & 1) ? relayMode : !relayMode);
+        digitalWrite(R2, (state & 2) ? relayMode : !relayMode);
+    }
+
+    // Уставки хранятся в long как сотые доли. Значение прежней прошивки (float)
+    // отличается старшим словом и переводится при загрузке, неверное заменяется fallback.
+    Centi loadSetting(int address, Centi min, Centi max, Centi fallback)
+    {
+        long stored = EEPROM.readLong(address);
+        int16_t high = (int16_t) (stored >> 16);
+        Centi value = fallback;
+        if (stored == -1L) {
+            // Чистая EEPROM.
+        } else if (high == 0 || high == -1) {
+            value = Centi::fromRaw((int16_t) stored);
+        } else {
+            float legacy;
+            memcpy(&legacy, &stored, sizeof(float));
+            if (legacy >= min.toFloat() && legacy <= max.toFloat()) {
+                value = Centi::fromFloat(legacy);
+            }
+        }
+        if (value < min || value > max) {
+            return fallback;
+        }
+        return value;
+    }
+
+    void saveSetting(int address, Centi value)
+    {
+        EEPROM.updateLong(address, (long) value.toRaw());
+    }
+
+    void boot()
+    {
+        if (bootStage == BOOT_STORAGE) {
+            EEPROM.setMemPool(0, EEPROMSizeNano);
+            EEPROM.isReady();
+
+            requiredTempAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
+            r1ThresholdAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
+            r2ThresholdAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
+            angleAddress = (uint8_t) EEPROM.getAddress(sizeof(long));
+
+            requiredTemp = loadSetting(requiredTempAddress, TEMP_MIN, TEMP_MAX, requiredTemp);
+            r1Threshold = loadSetting(r1ThresholdAddress, THRESHOLD_MIN, THRESHOLD_MAX, r1Threshold);
+            // Без сохраненного значения - порог по умолчанию, но не ниже порога Р1.
+            r2Threshold = loadSetting(r2ThresholdAddress, r1Threshold, THRESHOLD_MAX,
+                                      constrain(r2Threshold, r1Threshold, THRESHOLD_MAX));
+            angle.i = constrain(EEPROM.readInt(angleAddress), 0, 180);
+
+            radio.beginAuth(AUTH ? AUTH_KEY : nullptr);
+
+            relayStateAddress = (uint8_t) EEPROM.getAddress(sizeof(uint8_t));
+            restoreRelays();
+        } else if (bootStage == BOOT_SENSOR) {
+            // Первый замер запускается сразу, датчик прогревается параллельно с остальной периферией.
+            dht = new DHT_nonblocking(DHT22, DHT_TYPE_22);
+            tempReading = true;
+        } else if (bootStage == BOOT_SERVO) {
+            // Привод подключается в сохраненном положении без движения.
+            srv = new ServoEasing();
+            srv->attach(SRV, angle.i);
+            srv->setSpeed(SRV_SPEED);
+            srv->setEasingType(EASE_CUBIC_IN_OUT);
+            motionTarget = angle.i;
+        } else if (bootStage == BOOT_DISPLAY) {
+            oled = new U8X8_SH1106_128X64_NONAME_4W_HW_SPI(oledCs, oledDc, oledReset);
+            oled->begin();
+            render();
+        } else if (bootStage == BOOT_ENCODER) {
+            encoder.begin();
+        }
+        bootStage++;
+    }
+
     void tempControl()
     {
-        if (currentTemp.f <= (requiredTemp - r1Threshold)) {
+        if (currentTemp <= requiredTemp - r1Threshold) {
             relayOn(R1);
-            if (currentTemp.f <= (requiredTemp - r2Threshold)) {
+            if (currentTemp <= requiredTemp - r2Threshold) {
                 relayOn(R2);
             } else {
                 relayOff(R2);
@@ -141,57 +318,134 @@ public:
     const static uint8_t STATE_SET_TEMP = 2;
     const static uint8_t STATE_SET_R1 = 3;
     const static uint8_t STATE_SET_R2 = 4;
+    const static uint8_t STATE_DIAG = 5;
 
+    // Периферия поднимается поэтапно в tick(), конструктор только настраивает радио.
     RemoteController(uint8_t cs, uint8_t dc, uint8_t reset) : Controller(cs, dc, reset)
     {
-        pinMode(R1, OUTPUT);
-        pinMode(R2, OUTPUT);
+        oledCs = cs;
+        oledDc = dc;
+        oledReset = reset;
 
-        relayOff(R1);
-        relayOff(R2);
-
-        currentTemp.f = 0;
-        currentHum.f = 0;
-
-        oled = new U8X8_SH1106_128X64_NONAME_4W_HW_SPI(cs, dc, reset);
-        oled->begin();
-
-        EEPROM.setMemPool(0, EEPROMSizeNano);
-        EEPROM.isReady();
+    }
 
-        requiredTempAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
-        r1ThresholdAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
-        r2ThresholdAddress = (uint8_t) EEPROM.getAddress(sizeof(float));
-        angleAddress = (uint8_t) EEPROM.getAddress(sizeof(long));
+    void setSrv(int target)
+    {
+        angle.i = constrain(target, 0, 180);
+        // Плавное движение обновляется из прерывания таймера, опрос в tick() не нужен.
+        srv->startEaseTo(angle.i, SRV_SPEED, START_UPDATE_BY_INTERRUPT);
+        EEPROM.updateInt(angleAddress, angle.i);
+        render();
+    }
 
-        requiredTemp = EEPROM.readFloat(requiredTempAddress);
-        r1Threshold = EEPROM.readFloat(r1ThresholdAddress);
-        r2Threshold = EEPROM.readFloat(r2ThresholdAddress);
-        angle.i = EEPROM.readInt(angleAddress);
+    // Добавляет смещение клапана в текущую пачку команд. Пачка превращается
+    // в одну абсолютную цель после паузы MOTION_WINDOW, ответ уходит после остановки.
+    void queueSrv(long diff, bool report)
+    {
+        queueSrvTo((motionPending ? motionTarget : angle.i) + diff * 10, report);
+    }
 
-        srv = new ServoEasing();
-        srv->attach(SRV);
-        srv->setSpeed(10);
-        srv->setEasingType(EASE_CUBIC_IN_OUT);
-        updateSrv(0);
+    void queueSrvTo(int target, bool report)
+    {
+        unsigned long m = millis();
+        if (!motionPending) {
+            motionPending = true;
+            motionFirst = m;
+        }
+        motionLast = m;
+        motionTarget = constrain(target, 0, 180);
+        reportOnSettle = reportOnSettle || report;
+    }
 
-        dht = new DHT_nonblocking(DHT22, DHT_TYPE_22);
+    void planMotion()
+    {
+        unsigned long m = millis();
+        if (motionPending &&
+            ((m - motionLast) >= MOTION_WINDOW || (m - motionFirst) >= MOTION_MAX_DELAY)) {
+            motionPending = false;
+            setSrv(motionTarget);
+            motionSettling = true;
+        }
+        if (motionSettling && !srv->isMoving()) {
+            motionSettling = false;
+        }
+        // Ответ на команду откладывается, пока бюджет эфира не позволит его передать.
+        // Повтор раз в ACK_RETRY, а не в каждом loop(): каждая попытка собирает кадр
+        // и перерисовывает индикатор передачи.
+        if ((m - ackDeniedAt) < ACK_RETRY) {
+            return;
+        }
+        if (reportOnSettle && !motionPending && !motionSettling) {
+            reportOnSettle = !sendTelemetry(TxScheduler::PRIORITY_ACK);
+            if (reportOnSettle) {
+                ackDeniedAt = m;
+            }
+        }
+        if (configAckPending) {
+            sendConfigAck();
+        }
+    }
 
-        encoder = new RotaryEncoder(A2, A3);
+    void sendConfigAck()
+    {
+        configAckPending = !sendConfig(configAccepted);
+        if (configAckPending) {
+            ackDeniedAt = millis();
+        }
     }
 
-    void updateSrv(long diff)
+    // Применяет поля запроса, прошедшие проверку, и возвращает маску принятых.
+    uint8_t applyConfig(const Frame::Config &cfg)
     {
-        angle.i += diff * 10;
-        if (angle.i < 0) {
-            angle.i = 0;
+        uint8_t accepted = 0;
+        if ((cfg.mask & CFG_ANGLE) && cfg.angle >= 0 && cfg.angle <= 180) {
+            queueSrvTo(cfg.angle, true);
+            accepted |= CFG_ANGLE;
         }
-        if (angle.i > 180) {
-            angle.i = 180;
+        Centi temp = Centi::fromRaw(cfg.requiredTemp);
+        if ((cfg.mask & CFG_TEMP) && temp >= TEMP_MIN && temp <= TEMP_MAX) {
+            requiredTemp = temp;
+            saveSetting(requiredTempAddress, requiredTemp);
+            accepted |= CFG_TEMP;
+        }
+        Centi r1 = r1Threshold;
+        Centi value = Centi::fromRaw(cfg.r1Threshold);
+        if ((cfg.mask & CFG_R1) && value >= THRESHOLD_MIN && value <= THRESHOLD_MAX) {
+            r1 = value;
+            accepted |= CFG_R1;
+        }
+        Centi r2 = r2Threshold;
+        value = Centi::fromRaw(cfg.r2Threshold);
+        if ((cfg.mask & CFG_R2) && value >= THRESHOLD_MIN && value <= THRESHOLD_MAX) {
+            r2 = value;
+            accepted |= CFG_R2;
+        }
+        // Второе реле включается при большем отклонении, чем первое.
+        if (r2 < r1) {
+            accepted &= ~(CFG_R1 | CFG_R2);
+        } else {
+            r1Threshold = r1;
+            r2Threshold = r2;
+            saveSetting(r1ThresholdAddress, r1Threshold);
+            saveSetting(r2ThresholdAddress, r2Threshold);
+        }
+        if (accepted & (CFG_TEMP | CFG_R1 | CFG_R2)) {
+            tempControl();
         }
-        srv->startEaseTo(angle.i);
-        EEPROM.updateInt(angleAddress, angle.i);
         render();
+        return accepted;
+    }
+
+    bool sendConfig(uint8_t accepted)
+    {
+        Frame::Config cfg{};
+        cfg.mask = accepted;
+        cfg.angle = (int16_t) (motionPending ? motionTarget : angle.i);
+        cfg.requiredTemp = requiredTemp.toRaw();
+        cfg.r1Threshold = r1Threshold.toRaw();
+        cfg.r2Threshold = r2Threshold.toRaw();
+
+        return radio.send(TxScheduler::PRIORITY_ACK, Frame::TYPE_CONFIG, &cfg, sizeof(Frame::Config));
     }
 
     void startReadingDHT22()
@@ -201,11 +455,14 @@ public:
 
     void render() override
     {
+        if (!oled) {
+            return;
+        }
         oled->clearDisplay();
         oled->setFont(u8x8_font_pxplusibmcgathin_f);
 
         if (displayState == STATE_INIT) {
-            char text[16]{};
+            char text[20]{};
             strcat(text, "   Temp: ");
             Format::temperature(text, requiredTemp);
             oled->drawUTF8(0, 0, text);
@@ -219,6 +476,11 @@ public:
             strcat(text, "Relay 2: ");
             Format::temperature(text, r2Threshold);
             oled->drawUTF8(0, 4, text);
+
+            if (firstFrameTime) {
+                sprintf(text, "Boot: %lums", firstFrameTime);
+                oled->drawUTF8(0, 6, text);
+            }
         } else if (displayState == STATE_DISPLAY) {
             if (relayIsOn(R1)) {
                 oled->setInverseFont(true);
@@ -232,47 +494,46 @@ public:
             oled->drawUTF8(3, 0, "R2");
             oled->setInverseFont(false);
 
-            char snrOutput[10]{};
-            dtostrf(snr, 2, 0, snrOutput);
-            strcat(snrOutput, "dB");
-            oled->drawUTF8(oled->getCols() - 8, 0, snrOutput);
-
-            float displayAngle = round((uint8_t) angle.i / 2);
-            char angleString[6]{};
-            char barOutput[16]{};
-            for (int i = 0; i < 12; ++i) {
-                if (i < displayAngle * 12 / 90) {
-                    strcat(barOutput, "#");
-                } else {
-                    strcat(barOutput, " ");
-                }
-            }
-            strcat(barOutput, ":");
-            dtostrf(displayAngle, 2, 0, angleString);
-            strcat(barOutput, angleString);
-            strcat(barOutput, "%");
-            oled->drawUTF8(0, 2, barOutput);
-
-            char humOutput[18]{};
-            strcpy(humOutput, "H:");
-            Format::humidity(humOutput, currentHum.f);
-            oled->drawUTF8(0, 4, humOutput);
+            RemoteScreen screen;
+            screen.build(radio.getSnr(), (uint8_t) angle.i / 2, currentHum, currentTemp);
+            oled->drawUTF8(oled->getCols() - 8, 0, screen.snr);
+            oled->drawUTF8(0, 2, screen.bar);
+            oled->drawUTF8(0, 4, screen.hum);
 
             oled->setFont(u8x8_font_px437wyse700b_2x2_f);
-            char tempOutput[18]{};
-            strcpy(tempOutput, "T:");
-            Format::temperature(tempOutput, currentTemp.f, true);
-            oled->drawUTF8(0, 6, tempOutput);
+            oled->drawUTF8(0, 6, screen.temp);
         } else if (displayState == STATE_SET_TEMP) {
             oled->drawUTF8(5, 0, "setup");
             oled->drawUTF8(2, 1, "temperature");
-            char output[8]{};
+            char output[10]{};
             Format::temperature(output, requiredTemp, true);
             oled->drawUTF8(5, 3, output);
         } else if (displayState == STATE_SET_R1) {
             displayRelay(R1);
         } else if (displayState == STATE_SET_R2) {
             displayRelay(R2);
+        } else if (displayState == STATE_DIAG) {
+            oled->drawUTF8(5, 0, "diag");
+            char line[20]{};
+            strcpy(line, "SNR: ");
+            Format::snr(line, radio.getSnr());
+            strcat(line, "dB");
+            oled->drawUTF8(0, 2, line);
+            sprintf(line, "Drop: %lu", dropped);
+            oled->drawUTF8(0, 3, line);
+            sprintf(line, "Boot: %lums", firstFrameTime);
+            oled->drawUTF8(0, 5, line);
+            sprintf(line, "Air: %lu/%lus", (unsigned long) radio.getScheduler().remaining(millis()) / 1000,
+                    (unsigned long) radio.getScheduler().getBudget() / 1000);
+            oled->drawUTF8(0, 7, line);
+            if (radio.getLowPowerRx()) {
+                sprintf(line, "CAD: %lu", radio.getLowPowerRx()->getWakeups());
+                oled->drawUTF8(0, 4, line);
+                sprintf(line, "I: %luuA", radio.getLowPowerRx()->getAverageCurrent());
+                oled->drawUTF8(0, 6, line);
+            } else {
+                oled->drawUTF8(0, 4, "RX: continuous");
+            }
         }
     }
 
@@ -287,35 +548,42 @@ public:
         return displayState;
     }
 
+    // Периодическая телеметрия отбрасывается первой, когда бюджета эфира не хватает.
     void sendData()
     {
-        oled->drawUTF8(oled->getCols() - 3, 0, "\xBB");
+        sendTelemetry(TxScheduler::PRIORITY_LOW);
+    }
 
-        while (LoRa.beginPacket() == 0) {
-            delay(100);
+    bool sendTelemetry(uint8_t priority)
+    {
+        // До первого замера передавать нечего.
+        if (bootStage != BOOT_DONE || tempStats.isEmpty()) {
+            return false;
         }
+        oled->drawUTF8(oled->getCols() - 3, 0, "\xBB");
 
-        LoRa.write(0);
-
-        LoRa.write(currentTemp.b[0]);
-        LoRa.write(currentTemp.b[1]);
-        LoRa.write(currentTemp.b[2]);
-        LoRa.write(currentTemp.b[3]);
-
-        LoRa.write(currentHum.b[0]);
-        LoRa.write(currentHum.b[1]);
-        LoRa.write(currentHum.b[2]);
-        LoRa.write(currentHum.b[3]);
-
-        LoRa.write(angle.b[0]);
-        LoRa.write(angle.b[1]);
-
-        LoRa.write((uint8_t) relayIsOn(R1));
-        LoRa.write((uint8_t) relayIsOn(R2));
-
-        LoRa.endPacket();
+        Frame::Telemetry t{};
+        t.errCode = tempStats.isReady() ? 0 : ERR_WARMUP;
+        t.temp = currentTemp.toRaw();
+        t.hum = currentHum.toRaw();
+        t.angle = (int16_t) angle.i;
+        t.r1 = (uint8_t) relayIsOn(R1);
+        t.r2 = (uint8_t) relayIsOn(R2);
+        t.tempMin = tempStats.getMin().toRaw();
+        t.tempMax = tempStats.getMax().toRaw();
+        t.tempMean = tempStats.getMean().toRaw();
+        bool sent = radio.send(priority, Frame::TYPE_TELEMETRY, &t, sizeof(Frame::Telemetry));
+        if (sent) {
+            // Первым может уйти и периодический кадр, если бюджет эфира отложил кадр замера.
+            if (!firstFrameTime) {
+                firstFrameTime = millis();
+            }
+            tempStats.resetWindow();
+            humStats.resetWindow();
+        }
 
         oled->drawUTF8(oled->getCols() - 2, 0, " ");
+        return sent;
     }
 
     void call(uint8_t type, uint8_t idx) override
@@ -327,52 +595,82 @@ public:
         } else if (getDisplayState() == RemoteController::STATE_SET_R1) {
             setDisplayState(RemoteController::STATE_SET_R2);
         } else if (getDisplayState() == RemoteController::STATE_SET_R2) {
+            setDisplayState(RemoteController::STATE_DIAG);
+        } else if (getDisplayState() == RemoteController::STATE_DIAG) {
             setDisplayState(RemoteController::STATE_DISPLAY);
         }
     }
 
     void tick()
     {
-        srv->update();
-        if (tempReading && dht->measure(&currentTemp.f, &currentHum.f)) {
+        if (bootStage != BOOT_DONE) {
+            boot();
+            return;
+        }
+        planMotion();
+        saveRelays();
+        float temp, hum;
+        if (tempReading && dht->measure(&temp, &hum)) {
             tempReading = false;
-            render();
-            tempControl();
+            // Значения вне диапазона DHT22 отбрасываются до фильтра.
+            if (temp >= -40 && temp <= 80 && hum >= 0 && hum <= 100) {
+                currentTemp = tempStats.add(Centi::fromFloat(temp));
+                currentHum = humStats.add(Centi::fromFloat(hum));
+                // Регулятор ждет полной медианы, чтобы выброс первого замера не переключил реле.
+                if (tempStats.isReady()) {
+                    tempControl();
+                }
+                // Первый кадр уходит сразу после первого замера, не дожидаясь периода
+                // телеметрии, с пометкой ERR_WARMUP.
+                if (!firstFrameTime) {
+                    sendTelemetry(TxScheduler::PRIORITY_NORMAL);
+                }
+                render();
+            }
         }
-        encoder->tick();
-        long pos = encoder->getPosition();
-        if (pos != prevPosition) {
+        // Клапан двигается по щелчкам, уставки - с ускорением при быстром вращении.
+        int16_t delta = encoder.take(displayState != STATE_DISPLAY);
+        if (delta) {
             if (displayState == STATE_DISPLAY) {
-                updateSrv(pos - prevPosition);
+                queueSrv(delta, false);
             } else if (displayState == STATE_SET_TEMP) {
-                requiredTemp += ((pos - prevPosition) / 10.0);
-                EEPROM.updateFloat(requiredTempAddress, requiredTemp);
+                requiredTemp = constrain(requiredTemp + Centi::fromFraction(delta, 10), TEMP_MIN, TEMP_MAX);
+                saveSetting(requiredTempAddress, requiredTemp);
             } else if (displayState == STATE_SET_R1) {
-                r1Threshold += ((pos - prevPosition) / 10.0);
-                EEPROM.updateFloat(r1ThresholdAddress, r1Threshold);
+                r1Threshold = constrain(r1Threshold + Centi::fromFraction(delta, 10), THRESHOLD_MIN, r2Threshold);
+                saveSetting(r1ThresholdAddress, r1Threshold);
             } else if (displayState == STATE_SET_R2) {
-                r2Threshold += ((pos - prevPosition) / 10.0);
-                EEPROM.updateFloat(r2ThresholdAddress, r2Threshold);
+                r2Threshold = constrain(r2Threshold + Centi::fromFraction(delta, 10), r1Threshold, THRESHOLD_MAX);
+                saveSetting(r2ThresholdAddress, r2Threshold);
             }
-            prevPosition = pos;
             render();
         }
 
 
-        int packetSize = LoRa.parsePacket();
+        int packetSize = radio.available();
         if (packetSize) {
             oled->drawUTF8(oled->getCols() - 3, 0, "\xAB");
 
-            uint8_t cmd = (uint8_t) LoRa.read();
-            if (cmd == CMD_UP) {
-                updateSrv(1);
-                sendData();
-            } else if (cmd == CMD_DOWN) {
-                updateSrv(-1);
-                sendData();
+            uint8_t packet[Frame::MAX_SIZE];
+            uint8_t length = radio.read(packet, packetSize);
+
+            uint8_t type = radio.check(packet, length);
+            if (type == Frame::TYPE_UP) {
+                queueSrv(1, true);
+            } else if (type == Frame::TYPE_DOWN) {
+                queueSrv(-1, true);
+            } else if (type == Frame::TYPE_GET_CONFIG) {
+                // Запросом настроек домашний блок начинает работу после перезагрузки.
+                radio.requestSync();
+                configAccepted = 0;
+                sendConfigAck();
+            } else if (type == Frame::TYPE_SET_CONFIG) {
+                configAccepted = applyConfig(*Frame::view<Frame::Config>(packet));
+                sendConfigAck();
+            } else {
+                dropped++;
             }
 
-            snr = LoRa.packetSnr();
             oled->drawUTF8(oled->getCols() - 2, 0, " ");
         }
     }
@@ -394,18 +692,16 @@ void sendData()
 
 void toDisplay()
 {
-    ctrl->startReadingDHT22();
     ctrl->setDisplayState(RemoteController::STATE_DISPLAY);
 }
 
 void setup(void)
 {
     ctrl = new RemoteController(OLED_CS, OLED_DC, OLED_RESET);
-    ctrl->render();
 
     task = new Task(3);
     task->each(updateDHT22, 8000);
-    task->each(sendData, 10000);
+    task->each(sendData, RADIO_TELEMETRY_INTERVAL);
     task->one(toDisplay, 5000);
 
     sw1 = new Button(A7);
@@ -0,0 +1,78 @@
+// Стоимость аутентификации кадра (libraries/Auth) на хосте.
+//
+// Сборка на хосте:
+//   g++ -O2 -I libraries/Auth -I libraries/Frame -o authbench
+//       tools/authbench.cpp libraries/Auth/Auth.cpp libraries/Frame/Frame.cpp
+//
+// Для каждого типа кадра печатает время подписи и проверки и число раундов
+// SipHash на тег: на ATmega328 время тега пропорционально числу раундов.
+
+#include <Auth.h>
+#include <Frame.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const uint8_t KEY[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// Сообщение тега: кадр, 4 байта счетчика и идентификатор отправителя.
+unsigned sipRounds(uint8_t frameLength) {
+    unsigned message = frameLength + 5;
+    return 2 * (message / 8 + 1) + 4;
+}
+
+void bench(const char *name, uint8_t type, uint8_t size) {
+    uint8_t payload[Frame::MAX_SIZE]{};
+    uint8_t frame[Frame::MAX_SIZE];
+    uint8_t length = Frame::encode(frame, type, payload, size, true);
+
+    Auth tx(KEY, 'R', 'H');
+    Auth rx(KEY, 'H', 'R');
+    tx.begin(0, 0);
+    rx.begin(0, 0);
+
+    const unsigned long n = 200000;
+    unsigned long verified = 0;
+    double signNs = 0;
+    double verifyNs = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        uint8_t out[Frame::MAX_SIZE];
+        memcpy(out, frame, length);
+        auto t0 = std::chrono::steady_clock::now();
+        uint8_t signedLength = tx.sign(out, length);
+        auto t1 = std::chrono::steady_clock::now();
+        verified += rx.verify(out, signedLength);
+        auto t2 = std::chrono::steady_clock::now();
+        signNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        verifyNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+    }
+    printf("%-10s frame %2u+%u bytes  sipround %2u  sign %6.1f ns  verify %6.1f ns  ok %lu/%lu\n",
+           name, length, Auth::TRAILER_SIZE, sipRounds(length), signNs / n, verifyNs / n, verified, n);
+}
+
+}
+
+int main() {
+    bench("command", Frame::TYPE_UP, 0);
+    bench("telemetry", Frame::TYPE_TELEMETRY, sizeof(Frame::Telemetry));
+    bench("config", Frame::TYPE_CONFIG, sizeof(Frame::Config));
+
+    // Худший случай проверки: подделка, перебор MAX_RESYNC значений счетчика.
+    uint8_t frame[Frame::MAX_SIZE]{};
+    uint8_t length = Frame::encode(frame, Frame::TYPE_UP, nullptr, 0, true);
+    memset(frame + length, 0xA5, Auth::TRAILER_SIZE);
+    Auth rx(KEY, 'H', 'R');
+    rx.begin(0, 0);
+    const unsigned long n = 20000;
+    auto t0 = std::chrono::steady_clock::now();
+    unsigned long accepted = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        accepted += rx.verify(frame, length + Auth::TRAILER_SIZE);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+    printf("forged     %u tags per frame  verify %6.1f ns  accepted %lu\n", Auth::MAX_RESYNC, ns, accepted);
+    return 0;
+}
@@ -0,0 +1,703 @@
+// Микробенчмарки библиотек на хосте: Task, Switcher, Format и путь радиокадра.
+//
+// Сборка на хосте (из корня репозитория):
+//   cmake -S . -B build -DWINTERHOME_HOST_TOOLS=ON
+//   cmake --build build --target benchmark
+//
+// Запуск:
+//   benchmark [--filter substr] [--min-time ms] [--repetitions n]
+//             [--csv | --json] [--baseline file.csv [--threshold percent] [--min-delta ns]]
+//
+// Каждый бенчмарк повторяется, пока не наберет --min-time, итог - медиана времени
+// операции из --repetitions прогонов (по умолчанию 5) и разброс прогонов min..max.
+// Прогоны идут кругами по всем выбранным бенчмаркам.
+// --csv печатает "name,iterations,ns_per_op,cycles_per_op,min_ns,max_ns", этот же файл
+// принимает --baseline: для каждого бенчмарка печатается разница медиан с базой.
+// Регрессия (код 1) - когда даже самый быстрый прогон медленнее самого медленного
+// прогона базы больше чем на --threshold процентов (по умолчанию 10) и на --min-delta нс
+// (по умолчанию 1). Шум хоста раздвигает диапазоны, а не дает ложных регрессий,
+// у операций в единицы наносекунд сдвиг на такт не считается замедлением.
+//
+// Абсолютные числа относятся к хосту, не к ATmega328: сравнивать имеет смысл
+// только прогоны на одной машине, но соотношения и регрессии переносятся.
+// На x86 рядом с ns/op печатаются такты счетчика TSC на операцию.
+//
+// Пары fixed/* и float/* меряют одно и то же вычисление на Centi и на float:
+// решение регулятора, медиану с EWMA и форматирование. У хоста есть FPU, у
+// ATmega328 нет, поэтому на хосте разница - нижняя оценка выигрыша Centi.
+
+#include <Arduino.h>
+#include <Auth.h>
+#include <Fixed.h>
+#include <Format.h>
+#include <Frame.h>
+#include <Link.h>
+#include <RemoteScreen.h>
+#include <RemoteState.h>
+#include <SensorStats.h>
+#include <Switcher.h>
+#include <Task.h>
+#include <TrendBuffer.h>
+#include <TxScheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+// Не дает компилятору выбросить вычисление результата.
+template<typename T>
+inline void keep(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber() {
+    asm volatile("" : : : "memory");
+}
+
+// Бенчмарк, который меряет не тот путь (например, отвергнутый кадр), хуже отсутствующего.
+void expect(bool condition, const char *what) {
+    if (!condition) {
+        fprintf(stderr, "benchmark precondition failed: %s\n", what);
+        exit(3);
+    }
+}
+
+typedef void (*Body)(unsigned long n);
+
+struct Benchmark {
+    const char *name;
+    Body body;
+};
+
+const uint8_t KEY[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+volatile unsigned long fired = 0;
+
+void onTask() {
+    fired++;
+}
+
+// --- Task ---
+
+template<int TASKS>
+void taskTickIdle(unsigned long n) {
+    hostBoard->micros = 0;
+    Task task;
+    for (int i = 0; i < TASKS; i++) {
+        task.each(onTask, 60000);
+    }
+    for (unsigned long i = 0; i < n; i++) {
+        task.tick();
+        clobber();
+    }
+}
+
+template<int TASKS>
+void taskTickDue(unsigned long n) {
+    hostBoard->micros = 0;
+    Task task;
+    for (int i = 0; i < TASKS; i++) {
+        task.each(onTask, 1);
+    }
+    for (unsigned long i = 0; i < n; i++) {
+        hostBoard->micros += 1000;
+        task.tick();
+    }
+}
+
+void taskOne(unsigned long n) {
+    hostBoard->micros = 0;
+    Task task;
+    for (unsigned long i = 0; i < n; i++) {
+        task.one(onTask, 0);
+        task.tick();
+    }
+}
+
+// --- Switcher ---
+
+void switcherAddHandler(unsigned long n) {
+    for (unsigned long i = 0; i < n; i++) {
+        Switcher sw(2);
+        sw.addHandler(onTask, Switcher::DEFAULT_PRESS);
+        sw.addHandler(onTask, 500);
+        sw.addHandler(onTask, 2000);
+        keep(sw);
+    }
+}
+
+void switcherTickIdle(unsigned long n) {
+    hostBoard->pins[2] = HIGH;
+    Switcher sw(2);
+    sw.addHandler(onTask, Switcher::DEFAULT_PRESS);
+    sw.addHandler(onTask, 500);
+    for (unsigned long i = 0; i < n; i++) {
+        hostBoard->micros += 1000;
+        sw.tick();
+        clobber();
+    }
+}
+
+// Нажатие и отпускание с вызовом обработчика длинного нажатия.
+void switcherPress(unsigned long n) {
+    Switcher sw(2);
+    sw.addHandler(onTask, Switcher::DEFAULT_PRESS);
+    sw.addHandler(onTask, 500);
+    for (unsigned long i = 0; i < n; i++) {
+        hostBoard->pins[2] = LOW;
+        sw.tick();
+        hostBoard->micros += 600000;
+        hostBoard->pins[2] = HIGH;
+        sw.tick();
+    }
+}
+
+// --- Format ---
+
+void formatTemperature(unsigned long n) {
+    char out[16];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::temperature(out, Centi::fromRaw((int16_t) (i % 9000 - 4000)));
+        keep(out);
+    }
+}
+
+void formatTemperatureUnits(unsigned long n) {
+    char out[16];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::temperature(out, Centi::fromRaw((int16_t) (i % 9000 - 4000)), true);
+        keep(out);
+    }
+}
+
+void formatHumidity(unsigned long n) {
+    char out[16];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::humidity(out, Centi::fromRaw((int16_t) (i % 10000)));
+        keep(out);
+    }
+}
+
+void formatPressureHpa(unsigned long n) {
+    char out[24];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::pressure(out, 950.0f + (float) (i % 1000) / 10.0f, Format::PRESSURE_HPA, true);
+        keep(out);
+    }
+}
+
+void formatPressureMmhg(unsigned long n) {
+    char out[24];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::pressure(out, 950.0f + (float) (i % 1000) / 10.0f, Format::PRESSURE_MMHG, true);
+        keep(out);
+    }
+}
+
+// Строки экрана STATE_DISPLAY пульта (RemoteController::render) без вывода на OLED.
+void renderDisplay(unsigned long n) {
+    RemoteScreen screen;
+    for (unsigned long i = 0; i < n; i++) {
+        screen.build(28, (uint8_t) ((i % 181) / 2), Centi::fromRaw(4550), Centi::fromRaw((int16_t) (i % 3000)));
+        keep(screen);
+    }
+}
+
+// --- Centi и float ---
+
+// Температуры вокруг уставки 5 °C: регулятор включает Р1 и Р2 в разных комбинациях.
+inline int16_t sampleRaw(unsigned long i) {
+    return (int16_t) (300 + (i * 37) % 400);
+}
+
+// Решение tempControl() пульта на Centi.
+void fixedControl(unsigned long n) {
+    Centi required = Centi::fromInt(5);
+    Centi r1 = Centi::fromFraction(5, 10);
+    Centi r2 = Centi::fromInt(1);
+    uint8_t relays = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        Centi current = Centi::fromRaw(sampleRaw(i));
+        keep(current);
+        relays = current <= required - r1 ? (current <= required - r2 ? 3 : 1) : 0;
+        keep(relays);
+    }
+}
+
+void floatControl(unsigned long n) {
+    float required = 5;
+    float r1 = 0.5f;
+    float r2 = 1;
+    uint8_t relays = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        float current = sampleRaw(i) / 100.0f;
+        keep(current);
+        relays = current <= required - r1 ? (current <= required - r2 ? 3 : 1) : 0;
+        keep(relays);
+    }
+}
+
+// Медиана трех и EWMA с весом 1/4: SensorStats и то же самое на float.
+void fixedEwma(unsigned long n) {
+    SensorStats stats(2);
+    for (unsigned long i = 0; i < n; i++) {
+        keep(stats.add(Centi::fromRaw(sampleRaw(i))));
+    }
+}
+
+void floatEwma(unsigned long n) {
+    float history[3]{};
+    float ewma = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        history[i % 3] = sampleRaw(i) / 100.0f;
+        float a = history[0], b = history[1], c = history[2];
+        float median = std::fmax(std::fmin(a, b), std::fmin(std::fmax(a, b), c));
+        ewma = i == 0 ? median : ewma + (median - ewma) * 0.25f;
+        keep(ewma);
+    }
+}
+
+void fixedFormatTemperature(unsigned long n) {
+    char out[16];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::temperature(out, Centi::fromRaw(sampleRaw(i)), true);
+        keep(out);
+    }
+}
+
+// Прежний вывод температуры пульта: dtostrf() с одним знаком.
+void floatFormatTemperature(unsigned long n) {
+    char out[16];
+    for (unsigned long i = 0; i < n; i++) {
+        dtostrf(sampleRaw(i) / 100.0f, 2, 1, out);
+        strcat(out, "°C");
+        keep(out);
+    }
+}
+
+void fixedFormatSnr(unsigned long n) {
+    char out[8];
+    for (unsigned long i = 0; i < n; i++) {
+        out[0] = 0;
+        Format::snr(out, (int8_t) (i % 80 - 40));
+        keep(out);
+    }
+}
+
+void floatFormatSnr(unsigned long n) {
+    char out[8];
+    for (unsigned long i = 0; i < n; i++) {
+        dtostrf((int8_t) (i % 80 - 40) * 0.25f, 2, 0, out);
+        keep(out);
+    }
+}
+
+// --- Радиокадр ---
+
+Frame::Telemetry sampleTelemetry(unsigned long i) {
+    Frame::Telemetry t{};
+    t.temp = (int16_t) (1850 + i % 100);
+    t.hum = 4550;
+    t.angle = 90;
+    t.r1 = 1;
+    t.tempMin = 1800;
+    t.tempMax = 1950;
+    t.tempMean = 1870;
+    return t;
+}
+
+void frameEncode(unsigned long n) {
+    uint8_t frame[Frame::MAX_SIZE];
+    for (unsigned long i = 0; i < n; i++) {
+        Frame::Telemetry t = sampleTelemetry(i);
+        keep(Frame::encode(frame, Frame::TYPE_TELEMETRY, &t, sizeof(t), true));
+        keep(frame);
+    }
+}
+
+void frameValidate(unsigned long n) {
+    uint8_t frame[Frame::MAX_SIZE];
+    Frame::Telemetry t = sampleTelemetry(0);
+    uint8_t length = Frame::encode(frame, Frame::TYPE_TELEMETRY, &t, sizeof(t), true) + Auth::TRAILER_SIZE;
+    for (unsigned long i = 0; i < n; i++) {
+        keep(frame);
+        keep(Frame::validate(frame, length));
+    }
+}
+
+void authSign(unsigned long n) {
+    uint8_t frame[Frame::MAX_SIZE];
+    Frame::Telemetry t = sampleTelemetry(0);
+    uint8_t length = Frame::encode(frame, Frame::TYPE_TELEMETRY, &t, sizeof(t), true);
+    Auth tx(KEY, 'R', 'H');
+    tx.begin(0, 0);
+    for (unsigned long i = 0; i < n; i++) {
+        keep(tx.sign(frame, length));
+        keep(frame);
+    }
+}
+
+// Проверка требует растущего счетчика, поэтому меряется вместе с подписью.
+void authSignVerify(unsigned long n) {
+    uint8_t frame[Frame::MAX_SIZE];
+    Frame::Telemetry t = sampleTelemetry(0);
+    uint8_t length = Frame::encode(frame, Frame::TYPE_TELEMETRY, &t, sizeof(t), true);
+    Auth tx(KEY, 'R', 'H');
+    Auth rx(KEY, 'H', 'R');
+    tx.begin(0, 0);
+    rx.begin(0, 0);
+    for (unsigned long i = 0; i < n; i++) {
+        uint8_t signedLength = tx.sign(frame, length);
+        expect(rx.verify(frame, signedLength), "signed telemetry verifies");
+    }
+}
+
+// Подделка: перебор MAX_RESYNC значений счетчика.
+void authVerifyForged(unsigned long n) {
+    uint8_t frame[Frame::MAX_SIZE];
+    Frame::Telemetry t = sampleTelemetry(0);
+    uint8_t length = Frame::encode(frame, Frame::TYPE_TELEMETRY, &t, sizeof(t), true);
+    memset(frame + length, 0xA5, Auth::TRAILER_SIZE);
+    Auth rx(KEY, 'H', 'R');
+    rx.begin(0, 0);
+    for (unsigned long i = 0; i < n; i++) {
+        keep(frame);
+        expect(!rx.verify(frame, length + Auth::TRAILER_SIZE), "forged frame rejected");
+    }
+}
+
+// Телеметрия от датчика до тренда: пульт фильтрует, кодирует и подписывает,
+// станция проверяет и разбирает кадр теми же Link::check() и RemoteState::apply(), что HomeController.
+void telemetryPath(unsigned long n) {
+    SensorStats tempStats(2);
+    Auth tx(KEY, 'R', 'H');
+    Auth rx(KEY, 'H', 'R');
+    tx.begin(0, 0);
+    rx.begin(0, 0);
+    TrendBuffer trend;
+    RemoteState remote;
+    unsigned long m = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        m += 30000;
+        Centi filtered = tempStats.add(Centi::fromRaw((int16_t) (1850 + i % 64)));
+
+        Frame::Telemetry out = sampleTelemetry(i);
+        out.temp = filtered.toRaw();
+        out.tempMin = tempStats.getMin().toRaw();
+        out.tempMax = tempStats.getMax().toRaw();
+        out.tempMean = tempStats.getMean().toRaw();
+        tempStats.resetWindow();
+
+        uint8_t packet[Frame::MAX_SIZE];
+        uint8_t length = Frame::encode(packet, Frame::TYPE_TELEMETRY, &out, sizeof(out), true);
+        length = tx.sign(packet, length);
+
+        expect(Link::check(&rx, packet, length) == Frame::TYPE_TELEMETRY, "telemetry frame accepted");
+        remote.apply(*Frame::view<Frame::Telemetry>(packet));
+        trend.add(m, remote.tempMin, remote.tempMax, remote.r1, remote.r2);
+        keep(remote);
+    }
+    keep(trend);
+}
+
+void sensorStatsAdd(unsigned long n) {
+    SensorStats stats(2);
+    for (unsigned long i = 0; i < n; i++) {
+        keep(stats.add(Centi::fromRaw((int16_t) (1850 + (i * 37) % 200))));
+    }
+}
+
+void trendAdd(unsigned long n) {
+    TrendBuffer trend;
+    unsigned long m = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        m += 30000;
+        trend.add(m, Centi::fromRaw((int16_t) (1800 + i % 300)), Centi::fromRaw((int16_t) (1900 + i % 300)),
+                  (i & 1) != 0, (i & 2) != 0);
+    }
+    keep(trend);
+}
+
+void txSchedulerAllow(unsigned long n) {
+    TxScheduler scheduler(1, 20);
+    unsigned long m = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        m += 1000;
+        if (scheduler.allow((uint8_t) (i % 3), 60, m)) {
+            scheduler.commit(60, m);
+        }
+    }
+    keep(scheduler);
+}
+
+const Benchmark BENCHMARKS[] = {
+        {"task/tick/idle/1",         taskTickIdle<1>},
+        {"task/tick/idle/4",         taskTickIdle<4>},
+        {"task/tick/due/1",          taskTickDue<1>},
+        {"task/tick/due/4",          taskTickDue<4>},
+        {"task/one",                 taskOne},
+        {"switcher/addHandler/3",    switcherAddHandler},
+        {"switcher/tick/idle",       switcherTickIdle},
+        {"switcher/tick/press",      switcherPress},
+        {"format/temperature",       formatTemperature},
+        {"format/temperature/units", formatTemperatureUnits},
+        {"format/humidity",          formatHumidity},
+        {"format/pressure/hpa",      formatPressureHpa},
+        {"format/pressure/mmhg",     formatPressureMmhg},
+        {"render/display",           renderDisplay},
+        {"frame/encode/telemetry",   frameEncode},
+        {"frame/validate/telemetry", frameValidate},
+        {"auth/sign/telemetry",      authSign},
+        {"auth/signVerify/telemetry", authSignVerify},
+        {"auth/verify/forged",       authVerifyForged},
+        {"frame/path/telemetry",     telemetryPath},
+        {"sensorstats/add",          sensorStatsAdd},
+        {"trend/add",                trendAdd},
+        {"txscheduler/allow",        txSchedulerAllow},
+        {"fixed/control",            fixedControl},
+        {"float/control",            floatControl},
+        {"fixed/ewma",               fixedEwma},
+        {"float/ewma",               floatEwma},
+        {"fixed/format/temperature", fixedFormatTemperature},
+        {"float/format/temperature", floatFormatTemperature},
+        {"fixed/format/snr",         fixedFormatSnr},
+        {"float/format/snr",         floatFormatSnr},
+};
+
+struct Result {
+    std::string name;
+    unsigned long iterations;
+    double ns;
+    // Такты TSC на операцию, 0 - счетчик недоступен.
+    double cycles;
+    // Самый быстрый и самый медленный повтор, нс на операцию.
+    double minNs;
+    double maxNs;
+};
+
+inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Sample {
+    double ns;
+    double cycles;
+};
+
+Sample elapsed(Body body, unsigned long n) {
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = cycles();
+    body(n);
+    uint64_t c1 = cycles();
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::nano>(t1 - t0).count(), (double) (c1 - c0)};
+}
+
+// Число итераций, при котором один прогон длится не меньше minTimeNs.
+unsigned long calibrate(const Benchmark &benchmark, double minTimeNs) {
+    unsigned long n = 1;
+    double ns = elapsed(benchmark.body, n).ns;
+    while (ns < minTimeNs && n < (1UL << 30)) {
+        // Оценка по прошлому прогону с запасом, но не больше чем в 10 раз за шаг.
+        double scale = ns > 0 ? minTimeNs * 1.2 / ns : 10;
+        if (scale > 10) {
+            scale = 10;
+        }
+        if (scale < 2) {
+            scale = 2;
+        }
+        n = (unsigned long) (n * scale);
+        ns = elapsed(benchmark.body, n).ns;
+    }
+    return n;
+}
+
+Result summarize(const char *name, unsigned long n, std::vector<Sample> &samples) {
+    std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) {
+        return a.ns < b.ns;
+    });
+    // Медиана не зависит от единичных прогонов, прерванных планировщиком, в обе стороны.
+    const Sample &median = samples[samples.size() / 2];
+    return {name, n, median.ns / n, median.cycles / n, samples.front().ns / n, samples.back().ns / n};
+}
+
+// Диапазоны повторов не пересекаются с запасом по порогу и абсолютному минимуму.
+bool isRegression(const Result &r, const Result &base, double threshold, double minDelta) {
+    double gap = r.minNs - base.maxNs;
+    return gap > minDelta && gap * 100 / base.maxNs > threshold;
+}
+
+bool loadBaseline(const char *path, std::map<std::string, Result> &baseline) {
+    FILE *f = fopen(path, "r");
+    if (f == nullptr) {
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        char *first = strchr(line, ',');
+        char *second = first != nullptr ? strchr(first + 1, ',') : nullptr;
+        if (second == nullptr || strncmp(line, "name,", 5) == 0) {
+            continue;
+        }
+        Result r{std::string(line, first), strtoul(first + 1, nullptr, 10), atof(second + 1), 0, 0, 0};
+        // В файле прежнего формата без min_ns,max_ns диапазон базы - одна медиана.
+        r.minNs = r.maxNs = r.ns;
+        sscanf(second + 1, "%*f,%lf,%lf,%lf", &r.cycles, &r.minNs, &r.maxNs);
+        baseline[r.name] = r;
+    }
+    fclose(f);
+    return true;
+}
+
+void usage() {
+    fprintf(stderr, "usage: benchmark [--filter substr] [--min-time ms] [--repetitions n]\n"
+                    "                 [--csv | --json] [--baseline file.csv [--threshold percent] [--min-delta ns]]\n");
+}
+
+}
+
+int main(int argc, char **argv) {
+    const char *filter = nullptr;
+    const char *baselinePath = nullptr;
+    double minTimeMs = 200;
+    double threshold = 10;
+    double minDelta = 1;
+    int repetitions = 5;
+    bool csv = false;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && hasValue) {
+            minTimeMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repetitions") == 0 && hasValue) {
+            repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && hasValue) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-delta") == 0 && hasValue) {
+            minDelta = atof(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if ((csv && json) || repetitions < 1 || minTimeMs <= 0) {
+        usage();
+        return 2;
+    }
+
+    std::map<std::string, Result> baseline;
+    if (baselinePath != nullptr && !loadBaseline(baselinePath, baseline)) {
+        fprintf(stderr, "cannot read baseline %s\n", baselinePath);
+        return 2;
+    }
+
+    std::vector<const Benchmark *> selected;
+    std::vector<unsigned long> iterations;
+    for (const Benchmark &benchmark : BENCHMARKS) {
+        if (filter == nullptr || strstr(benchmark.name, filter) != nullptr) {
+            selected.push_back(&benchmark);
+            iterations.push_back(calibrate(benchmark, minTimeMs * 1e6));
+        }
+    }
+    // Повторы идут кругами по всем тестам, а не подряд: замедление машины на
+    // несколько секунд попадает в один повтор каждого теста, а не во все повторы одного.
+    std::vector<std::vector<Sample>> samples(selected.size());
+    for (int r = 0; r < repetitions; r++) {
+        for (size_t i = 0; i < selected.size(); i++) {
+            samples[i].push_back(elapsed(selected[i]->body, iterations[i]));
+        }
+    }
+    std::vector<Result> results;
+    for (size_t i = 0; i < selected.size(); i++) {
+        results.push_back(summarize(selected[i]->name, iterations[i], samples[i]));
+    }
+
+    int regressions = 0;
+    if (csv) {
+        printf("name,iterations,ns_per_op,cycles_per_op,min_ns,max_ns\n");
+        for (const Result &r : results) {
+            printf("%s,%lu,%.3f,%.1f,%.3f,%.3f\n", r.name.c_str(), r.iterations, r.ns, r.cycles, r.minNs, r.maxNs);
+        }
+    } else if (json) {
+        printf("{\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            printf("    {\"name\": \"%s\", \"iterations\": %lu, \"real_time\": %.3f, \"time_unit\": \"ns\", "
+                   "\"cycles\": %.1f, \"real_time_min\": %.3f, \"real_time_max\": %.3f}%s\n",
+                   r.name.c_str(), r.iterations, r.ns, r.cycles, r.minNs, r.maxNs, i + 1 < results.size() ? "," : "");
+        }
+        printf("  ]\n}\n");
+    } else {
+        printf("%-28s %12s %12s %10s %17s", "benchmark", "iterations", "ns/op", "cycles/op", "min..max");
+        if (baselinePath != nullptr) {
+            printf(" %12s %9s", "baseline", "delta");
+        }
+        printf("\n");
+        for (const Result &r : results) {
+            printf("%-28s %12lu %12.1f %10.1f %8.1f..%-7.1f", r.name.c_str(), r.iterations, r.ns, r.cycles, r.minNs,
+                   r.maxNs);
+            if (baselinePath != nullptr) {
+                auto it = baseline.find(r.name);
+                if (it == baseline.end() || it->second.ns <= 0) {
+                    printf(" %12s %9s", "-", "new");
+                } else {
+                    double delta = (r.ns - it->second.ns) * 100 / it->second.ns;
+                    printf(" %12.1f %+8.1f%%", it->second.ns, delta);
+                    if (isRegression(r, it->second, threshold, minDelta)) {
+                        printf("  REGRESSION");
+                    }
+                }
+            }
+            printf("\n");
+        }
+    }
+
+    // Сравнение с базой работает и при --csv/--json: итог уходит в stderr.
+    if (baselinePath != nullptr) {
+        for (const Result &r : results) {
+            auto it = baseline.find(r.name);
+            if (it != baseline.end() && it->second.ns > 0 && isRegression(r, it->second, threshold, minDelta)) {
+                regressions++;
+                if (csv || json) {
+                    fprintf(stderr, "regression %s: %.1f -> %.1f ns\n", r.name.c_str(), it->second.ns, r.ns);
+                }
+            }
+        }
+        if (regressions > 0) {
+            fprintf(stderr, "%d benchmark(s) slower than baseline by more than %.0f%% in every repetition\n", regressions, threshold);
+            return 1;
+        }
+    }
+    return 0;
+}
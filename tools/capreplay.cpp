@@ -0,0 +1,283 @@
+// Воспроизведение записи кадров домашнего блока (формат libraries/Capture) через
+// сам скетч home/src/main.cpp (linksim/home.cpp) на плате HostBoard: запись попадает
+// в FIFO радио в свое время по millis() домашнего блока, а разбирает и показывает
+// кадр HomeController::tick(). Между записями loop() вызывается каждые 10 мс, поэтому
+// отрисовка, «нет сигнала» и тренд работают как на блоке.
+//
+// Сборка на хосте:
+//   cmake -S . -B build -DWINTERHOME_HOST_TOOLS=ON && cmake --build build --target capreplay
+//
+// Использование:
+//   capreplay <файл> [--key HEX] [--speed N] [--quiet]
+//
+// --key HEX  ключ AUTH_KEY домашнего блока (32 hex-символа); без ключа скетч работает
+//            как без AuthKey.h и подписанные кадры отбрасывает
+// --speed N  воспроизводить в N раз быстрее реального времени (по умолчанию без пауз)
+// --quiet    не печатать каждую запись и экран
+//
+// Если время в записи идет назад, домашний блок перезагружался: плата перезапускается,
+// EEPROM со счетчиками подписи сохраняется.
+//
+// Запись снимается с домашнего блока при CAPTURE = true, например
+//   pio device monitor -b 115200 --raw > trace.bin
+// Для каждой записи печатается заголовок и содержимое кадра, а при изменении - текст
+// экрана домашнего блока. Код возврата 1, если в записи есть телеметрия с некорректными
+// значениями или скетч не прочитал кадр до следующего.
+
+#include <Arduino.h>
+#include <Capture.h>
+#include <Fixed.h>
+#include <Frame.h>
+
+#include "linksim/Sketches.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Ключ домашнего скетча, см. capreplay/AuthKey.h.
+const uint8_t *capreplayKey = nullptr;
+
+namespace {
+
+// Длина AUTH_KEY из AuthKey.h.
+const uint8_t KEY_SIZE = 16;
+// Шаг вызова loop(), мкс, как по умолчанию в linksim.
+const uint64_t LOOP_STEP = 10000;
+
+struct Stats {
+    unsigned long records = 0;
+    unsigned long telemetry = 0;
+    unsigned long config = 0;
+    unsigned long other = 0;
+    unsigned long invalid = 0;
+    unsigned long reboots = 0;
+    // Время записи по часам домашнего блока, мс.
+    uint64_t span = 0;
+};
+
+// Домашний блок на своей плате. Пока идет воспроизведение, hostBoard указывает на нее.
+class Replay {
+    HostBoard board;
+    // Время модели, мкс.
+    uint64_t now = 0;
+    bool started = false;
+    uint32_t lastTime = 0;
+
+    void boot()
+    {
+        board.reset();
+        now = 0;
+        hostBoard = &board;
+        home::setup();
+    }
+
+    void runUntil(uint64_t at)
+    {
+        while (now < at) {
+            now += LOOP_STEP;
+            if (board.advance(LOOP_STEP)) {
+                board.dispatch();
+                home::loop();
+            }
+        }
+    }
+
+public:
+    Stats stats;
+
+    void play(const Capture::Record &r)
+    {
+        if (!started || r.time < lastTime) {
+            stats.reboots += started;
+            started = true;
+            boot();
+        } else {
+            stats.span += r.time - lastTime;
+        }
+        lastTime = r.time;
+        stats.records++;
+        runUntil((uint64_t) r.time * 1000);
+        board.receive(r.frame, r.length, r.rssi, r.snr / 4.0f);
+        runUntil(now + LOOP_STEP);
+    }
+
+    // Кадры, которые скетч не успел прочитать до следующего.
+    unsigned long overruns() const
+    {
+        return board.overruns;
+    }
+
+    // Текст экрана одной строкой, без значка приема в углу ("\xAB" или пробел).
+    std::string screen() const
+    {
+        std::string line;
+        size_t begin = 0;
+        for (size_t end = board.display.find('\n'); end != std::string::npos;
+             begin = end + 1, end = board.display.find('\n', begin)) {
+            std::string text = board.display.substr(begin, end - begin);
+            if (text == "\xAB" || text.find_first_not_of(' ') == std::string::npos) {
+                continue;
+            }
+            line += line.empty() ? text : " / " + text;
+        }
+        return line;
+    }
+};
+
+// Значения, которые домашний блок показал бы, в физически возможных пределах.
+bool plausible(const Frame::Telemetry &t) {
+    return t.errCode <= 2 && t.angle >= 0 && t.angle <= 180 &&
+           Centi::fromRaw(t.temp) > Centi::fromInt(-50) && Centi::fromRaw(t.temp) < Centi::fromInt(90) &&
+           Centi::fromRaw(t.hum) >= Centi::fromInt(0) && Centi::fromRaw(t.hum) <= Centi::fromInt(100) &&
+           t.tempMin <= t.tempMax;
+}
+
+// Тип кадра по заголовку и проверка телеметрии. Принял ли кадр скетч, видно по экрану.
+bool inspect(const Capture::Record &r, uint8_t &type, Stats &stats) {
+    type = Frame::validate(r.frame, r.length);
+    if (type == Frame::TYPE_TELEMETRY) {
+        stats.telemetry++;
+        if (!plausible(*Frame::view<Frame::Telemetry>(r.frame))) {
+            stats.invalid++;
+            return false;
+        }
+    } else if (type == Frame::TYPE_CONFIG) {
+        stats.config++;
+    } else {
+        stats.other++;
+    }
+    return true;
+}
+
+bool parseKey(const char *hex, uint8_t *key) {
+    if (strlen(hex) != 2 * KEY_SIZE) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEY_SIZE; i++) {
+        char byte[3] = {hex[2 * i], hex[2 * i + 1], 0};
+        char *end = nullptr;
+        key[i] = (uint8_t) strtoul(byte, &end, 16);
+        if (*end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print(const Capture::Record &r, uint8_t type, bool valid) {
+    printf("%10u ms %4d dBm %6.2f dB len %3u", r.time, r.rssi, r.snr / 4.0, r.length);
+    if (type == Frame::TYPE_TELEMETRY) {
+        const Frame::Telemetry &t = *Frame::view<Frame::Telemetry>(r.frame);
+        printf("  err %u t %.1f (%.1f..%.1f) h %.0f angle %d r1 %u r2 %u", t.errCode,
+               Centi::fromRaw(t.temp).toFloat(), Centi::fromRaw(t.tempMin).toFloat(),
+               Centi::fromRaw(t.tempMax).toFloat(), Centi::fromRaw(t.hum).toFloat(), t.angle, t.r1, t.r2);
+    } else if (type == Frame::TYPE_CONFIG) {
+        printf("  config");
+    } else if (type == Frame::TYPE_INVALID) {
+        printf("  malformed");
+    } else {
+        printf("  type %u", type);
+    }
+    printf("%s\n", valid ? "" : "  INVALID");
+}
+
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <capture> [--key HEX] [--speed N] [--quiet]\n", argv[0]);
+        return 2;
+    }
+    double speed = 0;
+    bool quiet = false;
+    uint8_t key[KEY_SIZE] = {};
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--key") == 0 && i + 1 < argc) {
+            if (!parseKey(argv[++i], key)) {
+                fprintf(stderr, "--key: expected %d hex digits\n", 2 * KEY_SIZE);
+                return 2;
+            }
+            capreplayKey = key;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        }
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    if (fd < 0) {
+        perror(argv[1]);
+        return 2;
+    }
+    struct stat st{};
+    fstat(fd, &st);
+    size_t size = (size_t) st.st_size;
+    if (size == 0) {
+        fprintf(stderr, "%s: empty capture\n", argv[1]);
+        return 2;
+    }
+    auto *data = (const uint8_t *) mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return 2;
+    }
+
+    Replay replay;
+    Capture::Record r{};
+    size_t offset = 0;
+    uint32_t prevTime = 0;
+    std::string shown;
+    while (Capture::next(data, size, offset, r)) {
+        if (speed > 0 && replay.stats.records > 0 && r.time > prevTime) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>((r.time - prevTime) / speed));
+        }
+        prevTime = r.time;
+        uint8_t type = Frame::TYPE_INVALID;
+        bool valid = inspect(r, type, replay.stats);
+        replay.play(r);
+        if (!quiet || !valid) {
+            print(r, type, valid);
+        }
+        if (!quiet && replay.screen() != shown) {
+            shown = replay.screen();
+            printf("%10s screen: %s\n", "", shown.c_str());
+        }
+    }
+    const Stats &stats = replay.stats;
+
+    // Скорость воспроизведения через скетч без вывода и пауз, каждый проход - с новой платы.
+    unsigned long passes = 0;
+    unsigned long played = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        Replay timed;
+        size_t o = 0;
+        while (Capture::next(data, size, o, r)) {
+            timed.play(r);
+            played++;
+        }
+        passes++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.2);
+
+    printf("records %lu telemetry %lu config %lu other %lu invalid %lu unread %lu reboots %lu\n",
+           stats.records, stats.telemetry, stats.config, stats.other, stats.invalid, replay.overruns(),
+           stats.reboots);
+    printf("screen: %s\n", replay.screen().c_str());
+    printf("replay: %.0f records/s, %.0fx real time\n", played / elapsed, passes * (stats.span / 1e3) / elapsed);
+
+    munmap((void *) data, size);
+    close(fd);
+    return stats.invalid || replay.overruns() ? 1 : 0;
+}
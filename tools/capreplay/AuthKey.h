@@ -0,0 +1,13 @@
+#ifndef WINTERHOME_AUTHKEY_H
+#define WINTERHOME_AUTHKEY_H
+
+#include <stdint.h>
+
+// Ключ для capreplay: домашний скетч собирается с аутентификацией, а сам ключ
+// задается при запуске (--key). Без ключа AUTH_KEY - nullptr, и скетч работает
+// без аутентификации, как без include/AuthKey.h.
+extern const uint8_t *capreplayKey;
+
+#define AUTH_KEY capreplayKey
+
+#endif //WINTERHOME_AUTHKEY_H
@@ -0,0 +1,172 @@
+// Проверка AcceleratedEncoder на записанных последовательностях квадратуры:
+// медленное, среднее и быстрое вращение, смена направления, дребезг контактов
+// и поток щелчков быстрее, чем основной цикл успевает их забирать.
+//
+// Сборка и запуск на хосте:
+//   cmake -S . -B build -DWINTERHOME_HOST_TOOLS=ON && cmake --build build --target encodertest
+//   ctest --test-dir build -R encodertest
+//
+// Код возврата 1 при первой ошибке.
+
+#include <Arduino.h>
+#include <AcceleratedEncoder.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+unsigned long failures = 0;
+
+#define CHECK_EQ(actual, expected)                                                             \
+    do {                                                                                       \
+        long a = (long) (actual), e = (long) (expected);                                       \
+        if (a != e) {                                                                          \
+            fprintf(stderr, "%s:%d: %s = %ld, expected %ld\n", __FILE__, __LINE__, #actual, a, e); \
+            failures++;                                                                        \
+        }                                                                                      \
+    } while (0)
+
+// Переходы выводов (бит 0 - pin1, бит 1 - pin2) за один щелчок от положения покоя.
+const uint8_t CW[] = {2, 3, 1, 0};
+const uint8_t CCW[] = {1, 3, 2, 0};
+
+// Щелчки через interval мс, переходы внутри щелчка равномерно; возвращает время последнего.
+unsigned long turn(AcceleratedEncoder &encoder, int8_t dir, uint16_t detents, unsigned long interval,
+                   unsigned long now) {
+    const uint8_t *sequence = dir > 0 ? CW : CCW;
+    for (uint16_t d = 0; d < detents; d++) {
+        unsigned long start = now;
+        now += interval;
+        for (uint8_t i = 0; i < 4; i++) {
+            encoder.update(sequence[i], start + (interval * (i + 1)) / 4);
+        }
+    }
+    return now;
+}
+
+void testSlow() {
+    AcceleratedEncoder encoder(A2, A3);
+    turn(encoder, 1, 10, 200, 1000);
+    CHECK_EQ(encoder.take(true), 10);
+    CHECK_EQ(encoder.take(true), 0);
+}
+
+void testMedium() {
+    AcceleratedEncoder encoder(A2, A3);
+    turn(encoder, 1, 10, 50, 1000);
+    // Первый щелчок без ускорения, следующие - по 5.
+    CHECK_EQ(encoder.take(true), 1 + 9 * 5);
+}
+
+void testFast() {
+    AcceleratedEncoder encoder(A2, A3);
+    turn(encoder, -1, 10, 10, 1000);
+    CHECK_EQ(encoder.take(true), -(1 + 9 * 10));
+}
+
+// Без ускорения (экран настроек) возвращаются сами щелчки.
+void testUnaccelerated() {
+    AcceleratedEncoder encoder(A2, A3);
+    turn(encoder, 1, 10, 10, 1000);
+    CHECK_EQ(encoder.take(false), 10);
+    CHECK_EQ(encoder.take(true), 0);
+}
+
+// При смене направления ускорение начинается заново.
+void testReversal() {
+    AcceleratedEncoder encoder(A2, A3);
+    unsigned long now = turn(encoder, 1, 5, 10, 1000);
+    CHECK_EQ(encoder.take(true), 1 + 4 * 10);
+    turn(encoder, -1, 5, 10, now);
+    CHECK_EQ(encoder.take(true), -(1 + 4 * 10));
+}
+
+// Переход от медленного вращения к быстрому и обратно.
+void testRamp() {
+    AcceleratedEncoder encoder(A2, A3);
+    unsigned long now = turn(encoder, 1, 3, 200, 1000);
+    now = turn(encoder, 1, 3, 50, now);
+    now = turn(encoder, 1, 3, 10, now);
+    turn(encoder, 1, 3, 200, now);
+    CHECK_EQ(encoder.take(false), 12);
+    CHECK_EQ(encoder.take(true), 0);
+    now = turn(encoder, 1, 3, 200, 5000);
+    CHECK_EQ(encoder.take(true), 3);
+    now = turn(encoder, 1, 3, 50, now);
+    CHECK_EQ(encoder.take(true), 3 * 5);
+    now = turn(encoder, 1, 3, 10, now);
+    CHECK_EQ(encoder.take(true), 3 * 10);
+    turn(encoder, 1, 3, 200, now);
+    CHECK_EQ(encoder.take(true), 3);
+}
+
+// Дребезг одного контакта в покое и посреди щелчка не дает лишних шагов и ускорения.
+void testBounce() {
+    AcceleratedEncoder encoder(A2, A3);
+    unsigned long now = 1000;
+    for (uint8_t i = 0; i < 5; i++) {
+        encoder.update(1, now);
+        encoder.update(0, now);
+    }
+    CHECK_EQ(encoder.take(true), 0);
+
+    for (uint8_t d = 0; d < 10; d++) {
+        now += 200;
+        const uint8_t bouncy[] = {2, 0, 2, 3, 2, 3, 1, 3, 1, 0, 1, 0};
+        for (uint8_t pins : bouncy) {
+            encoder.update(pins, now);
+        }
+    }
+    CHECK_EQ(encoder.take(true), 10);
+}
+
+// Поток щелчков с интервалом 2 мс между забором смещения основным циклом: ничего не теряется.
+void testHighRate() {
+    AcceleratedEncoder encoder(A2, A3);
+    unsigned long now = 1000;
+    long total = 0;
+    long steps = 0;
+    for (uint8_t batch = 0; batch < 20; batch++) {
+        now = turn(encoder, 1, 50, 2, now);
+        total += encoder.take(true);
+    }
+    CHECK_EQ(total, 1 + (20 * 50 - 1) * 10);
+    turn(encoder, -1, 300, 2, now);
+    steps = encoder.take(false);
+    CHECK_EQ(steps, -300);
+}
+
+// Вход через tick(): уровни выводов читаются из заглушки.
+void testTick() {
+    AcceleratedEncoder encoder(A2, A3);
+    hostBoard->pins[A2] = hostBoard->pins[A3] = LOW;
+    hostBoard->micros = 1000000;
+    encoder.begin();
+    hostBoard->pins[A2] = hostBoard->pins[A3] = HIGH;
+    encoder.tick();
+    hostBoard->pins[A2] = hostBoard->pins[A3] = LOW;
+    encoder.tick();
+    // Одновременная смена обоих выводов - недопустимый переход, шага нет.
+    CHECK_EQ(encoder.take(true), 0);
+}
+
+}
+
+int main() {
+    testSlow();
+    testMedium();
+    testFast();
+    testUnaccelerated();
+    testReversal();
+    testRamp();
+    testBounce();
+    testHighRate();
+    testTick();
+    if (failures) {
+        fprintf(stderr, "encodertest: %lu failures\n", failures);
+        return 1;
+    }
+    printf("encodertest: ok\n");
+    return 0;
+}
@@ -0,0 +1,293 @@
+// Фаззинг разбора кадров и записи: Frame::validate(), Link::check() с ключом и
+// без, RemoteState::apply() и Capture::next(). Заодно проверяется счетчик Auth:
+// после долгого пропуска получателя догоняет кадр синхронизации, а после его
+// перезагрузки ни один принятый кадр не принимается повторно.
+//
+// Сборка на хосте:
+//   cmake -S . -B build -DWINTERHOME_HOST_TOOLS=ON && cmake --build build --target framefuzz
+//
+// Использование:
+//   framefuzz [--iterations N] [--seed N]
+//
+// Без libFuzzer framefuzz сам генерирует входы: случайные байты, корректные
+// кадры с искаженными байтами и записи Capture с мусором. С clang и
+// -DWINTERHOME_FUZZ=ON собирается framefuzz_libfuzzer с той же проверкой
+// в LLVMFuzzerTestOneInput().
+//
+// При нарушении инварианта печатает вход в hex и возвращает 1.
+
+#include <Auth.h>
+#include <Capture.h>
+#include <Frame.h>
+#include <Link.h>
+#include <RemoteState.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint8_t KEY[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+void dump(const char *what, const uint8_t *data, size_t size) {
+    fprintf(stderr, "FAIL: %s\n  input (%zu bytes):", what, size);
+    for (size_t i = 0; i < size; i++) {
+        fprintf(stderr, " %02x", data[i]);
+    }
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+#define FUZZ_CHECK(cond, data, size) \
+    do { if (!(cond)) dump(#cond, data, size); } while (0)
+
+bool knownType(uint8_t type) {
+    return Frame::payloadSize(type) >= 0;
+}
+
+// Кадр в буфере ровно его длины, чтобы чтение за границу ловил ASan.
+uint8_t checkFrame(Auth *rx, const uint8_t *data, size_t size) {
+    std::vector<uint8_t> frame(data, data + size);
+    const uint8_t *p = frame.data();
+
+    uint8_t type = Frame::validate(p, size);
+    if (type != Frame::TYPE_INVALID) {
+        FUZZ_CHECK(knownType(type), p, size);
+        FUZZ_CHECK(!Frame::isSync(p) || Frame::isAuthenticated(p), p, size);
+        FUZZ_CHECK(size == Frame::HEADER_SIZE + (size_t) Frame::payloadSize(type) + Frame::trailerSize(p), p, size);
+        FUZZ_CHECK(size <= Frame::MAX_SIZE, p, size);
+    }
+    if (size > 0xFF) {
+        return Frame::TYPE_INVALID;
+    }
+
+    // Без ключа принимаются только неподписанные кадры, прошедшие validate().
+    uint8_t open = Link::check(nullptr, p, (uint8_t) size);
+    FUZZ_CHECK(open == Frame::TYPE_INVALID || (open == type && !Frame::isAuthenticated(p)), p, size);
+
+    // С ключом - только подписанные, и каждый не больше одного раза.
+    uint8_t keyed = Link::check(rx, p, (uint8_t) size);
+    FUZZ_CHECK(keyed == Frame::TYPE_INVALID || (keyed == type && Frame::isAuthenticated(p)), p, size);
+    if (keyed != Frame::TYPE_INVALID) {
+        FUZZ_CHECK(Link::check(rx, p, (uint8_t) size) == Frame::TYPE_INVALID, p, size);
+    }
+
+    uint8_t accepted = keyed != Frame::TYPE_INVALID ? keyed : open;
+    if (accepted == Frame::TYPE_TELEMETRY) {
+        RemoteState state;
+        state.apply(*Frame::view<Frame::Telemetry>(p));
+    }
+    return accepted;
+}
+
+// Capture::next() не выходит за буфер, всегда продвигается и находит каждую запись.
+void checkCapture(const uint8_t *data, size_t size) {
+    std::vector<uint8_t> buffer(data, data + size);
+    const uint8_t *p = buffer.data();
+    Capture::Record r{};
+    size_t offset = 0;
+    size_t previous = 0;
+    size_t records = 0;
+    while (Capture::next(p, size, offset, r)) {
+        FUZZ_CHECK(offset > previous, p, size);
+        FUZZ_CHECK(r.frame >= p + Capture::HEADER_SIZE, p, size);
+        FUZZ_CHECK(r.frame + r.length == p + offset, p, size);
+        FUZZ_CHECK(offset <= size, p, size);
+        FUZZ_CHECK(r.frame[-Capture::HEADER_SIZE] == Capture::SYNC_0, p, size);
+        previous = offset;
+        FUZZ_CHECK(++records <= size / Capture::HEADER_SIZE, p, size);
+    }
+    FUZZ_CHECK(offset <= size, p, size);
+}
+
+}
+
+#ifdef WINTERHOME_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    Auth rx(KEY, 'H', 'R');
+    rx.begin(0, 0);
+    checkFrame(&rx, data, size);
+    checkCapture(data, size);
+    return 0;
+}
+
+#else
+
+namespace {
+
+struct Generator {
+    std::mt19937 random;
+    Auth tx{KEY, 'R', 'H'};
+
+    explicit Generator(uint32_t seed) : random(seed) {
+        tx.begin(0, 0);
+    }
+
+    uint32_t next(uint32_t limit) {
+        return std::uniform_int_distribution<uint32_t>(0, limit - 1)(random);
+    }
+
+    void bytes(std::vector<uint8_t> &out, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            out.push_back((uint8_t) next(256));
+        }
+    }
+
+    // Корректный кадр случайного типа, подписанный или нет. Синхронизация - как в
+    // RadioLink::send(): по isSyncDue() и изредка без него, как до первого ответа собеседника.
+    std::vector<uint8_t> frame(bool authenticated) {
+        static const uint8_t TYPES[] = {Frame::TYPE_UP, Frame::TYPE_DOWN, Frame::TYPE_GET_CONFIG,
+                                        Frame::TYPE_SET_CONFIG, Frame::TYPE_CONFIG, Frame::TYPE_TELEMETRY};
+        uint8_t type = TYPES[next(sizeof(TYPES))];
+        std::vector<uint8_t> payload;
+        bytes(payload, (size_t) Frame::payloadSize(type));
+        uint8_t out[Frame::MAX_SIZE];
+        bool sync = authenticated && (tx.isSyncDue() || next(16) == 0);
+        uint8_t length = Frame::encode(out, type, payload.data(), (uint8_t) payload.size(), authenticated, sync);
+        if (authenticated) {
+            length = tx.sign(out, length, sync);
+        }
+        return std::vector<uint8_t>(out, out + length);
+    }
+
+    void mutate(std::vector<uint8_t> &data) {
+        uint32_t count = 1 + next(3);
+        for (uint32_t i = 0; i < count; i++) {
+            switch (next(4)) {
+                case 0:
+                    if (!data.empty()) data[next((uint32_t) data.size())] ^= (uint8_t) (1 << next(8));
+                    break;
+                case 1:
+                    if (!data.empty()) data[next((uint32_t) data.size())] = (uint8_t) next(256);
+                    break;
+                case 2:
+                    if (!data.empty()) data.pop_back();
+                    break;
+                default:
+                    data.push_back((uint8_t) next(256));
+                    break;
+            }
+        }
+    }
+
+    // Несколько записей Capture с мусором между ними и, возможно, обрезанным концом.
+    std::vector<uint8_t> capture() {
+        std::vector<uint8_t> out;
+        uint32_t records = next(6);
+        for (uint32_t i = 0; i < records; i++) {
+            bytes(out, next(4));
+            std::vector<uint8_t> f = frame(next(2) != 0);
+            uint8_t header[Capture::HEADER_SIZE];
+            Capture::header(header, next(1u << 31), (int16_t) (next(140) - 140), (int8_t) (next(40) - 20),
+                            (uint8_t) f.size());
+            out.insert(out.end(), header, header + sizeof(header));
+            out.insert(out.end(), f.begin(), f.end());
+        }
+        if (!out.empty() && next(4) == 0) {
+            out.resize(next((uint32_t) out.size()));
+        }
+        if (next(4) == 0) {
+            mutate(out);
+        }
+        return out;
+    }
+};
+
+}
+
+int main(int argc, char **argv) {
+    unsigned long iterations = 200000;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--iterations N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Generator g(seed);
+    Auth rx(KEY, 'H', 'R');
+    rx.begin(0, 0);
+    unsigned long accepted = 0;
+    unsigned long signedAccepted = 0;
+    unsigned long gaps = 0;
+    unsigned long reboots = 0;
+    // Принятые получателем кадры с последней перезагрузки.
+    std::vector<std::vector<uint8_t>> history;
+    // После пропуска или перезагрузки обычные кадры могут не проходить до первого кадра синхронизации.
+    bool lost = false;
+    for (unsigned long i = 0; i < iterations; i++) {
+        std::vector<uint8_t> data;
+        uint32_t action = g.next(256);
+        if (action == 0) {
+            // Получатель не слышит отправителя дольше окна MAX_RESYNC.
+            uint32_t skipped = g.next(Auth::MAX_RESYNC * 256 * 2);
+            for (uint32_t k = 0; k < skipped; k++) {
+                g.frame(true);
+            }
+            g.tx.requestSync();
+            lost = true;
+            gaps++;
+        } else if (action == 1) {
+            // Перезагрузка получателя с сохраненным счетчиком: принятое раньше не проходит снова.
+            rx.begin(0, rx.getRxLease());
+            for (const std::vector<uint8_t> &old : history) {
+                FUZZ_CHECK(Link::check(&rx, old.data(), (uint8_t) old.size()) == Frame::TYPE_INVALID,
+                           old.data(), old.size());
+            }
+            history.clear();
+            // Домашний блок после перезагрузки запрашивает настройки, удаленный отвечает синхронизацией.
+            g.tx.requestSync();
+            lost = true;
+            reboots++;
+        }
+        switch (g.next(4)) {
+            case 0:
+                g.bytes(data, g.next(Frame::MAX_SIZE + 8));
+                break;
+            case 1: {
+                // Неискаженный подписанный кадр со свежим счетчиком обязан пройти,
+                // после потери синхронизации - если это кадр синхронизации.
+                data = g.frame(true);
+                uint8_t type = checkFrame(&rx, data.data(), data.size());
+                if (lost && !Frame::isSync(data.data())) {
+                    checkCapture(data.data(), data.size());
+                    continue;
+                }
+                FUZZ_CHECK(type == Frame::validate(data.data(), data.size()) && type != Frame::TYPE_INVALID,
+                           data.data(), data.size());
+                lost = false;
+                signedAccepted++;
+                if (history.size() < 64) {
+                    history.push_back(data);
+                }
+                checkCapture(data.data(), data.size());
+                continue;
+            }
+            case 2:
+                data = g.frame(g.next(2) != 0);
+                g.mutate(data);
+                break;
+            default:
+                data = g.capture();
+                break;
+        }
+        if (checkFrame(&rx, data.data(), data.size()) != Frame::TYPE_INVALID) {
+            accepted++;
+        }
+        checkCapture(data.data(), data.size());
+    }
+    printf("framefuzz: %lu inputs, %lu signed frames accepted, %lu other inputs accepted, "
+           "%lu gaps, %lu reboots, seed %u\n", iterations, signedAccepted, accepted, gaps, reboots, seed);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef WINTERHOME_HOST_ARDUINO_H
+#define WINTERHOME_HOST_ARDUINO_H
+
+// Минимальная замена Arduino.h для сборки библиотек и скетчей на хосте
+// (tools/benchmark.cpp, tools/encodertest.cpp, tools/linksim.cpp).
+// Время, уровни выводов и периферия берутся из текущей платы hostBoard, см. HostBoard.h.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HostBoard.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A6 20
+#define A7 21
+
+#define bit(b) (1UL << (b))
+
+// Обработчик прерывания - обычная функция, модель вызывает ее сама.
+#define ISR(vector) void vector()
+
+// Регистры прерываний по изменению уровня (PCINT): записи принимаются и не действуют.
+static volatile uint8_t hostPcintRegister;
+#define digitalPinToPCMSK(p) (&hostPcintRegister)
+#define digitalPinToPCMSKbit(p) ((p) & 7)
+#define digitalPinToPCICR(p) (&hostPcintRegister)
+#define digitalPinToPCICRbit(p) 1
+#define PCIFR hostPcintRegister
+
+template<typename T, typename L, typename H>
+inline T constrain(T amount, L low, H high)
+{
+    return amount < low ? (T) low : (amount > high ? (T) high : amount);
+}
+
+inline unsigned long millis()
+{
+    return hostBoard->millis();
+}
+
+inline unsigned long micros()
+{
+    return (unsigned long) hostBoard->micros;
+}
+
+inline void delay(unsigned long ms)
+{
+    hostBoard->block(ms * 1000ULL);
+}
+
+inline void noInterrupts()
+{}
+
+inline void interrupts()
+{}
+
+inline void pinMode(uint8_t, uint8_t)
+{}
+
+inline void digitalWrite(uint8_t pin, uint8_t level)
+{
+    level = level ? HIGH : LOW;
+    if (hostBoard->pins[pin] != level) {
+        hostBoard->pins[pin] = level;
+        hostBoard->pinChanges[pin]++;
+    }
+}
+
+inline int digitalRead(uint8_t pin)
+{
+    return hostBoard->pins[pin];
+}
+
+inline int analogRead(uint8_t pin)
+{
+    return hostBoard->pins[pin] ? 1023 : 0;
+}
+
+inline char *dtostrf(double value, signed char width, unsigned char precision, char *out)
+{
+    sprintf(out, "%*.*f", width, precision, value);
+    return out;
+}
+
+// Serial: вывод отбрасывается.
+class HardwareSerial {
+public:
+    void begin(long)
+    {}
+
+    size_t write(uint8_t)
+    {
+        return 1;
+    }
+
+    size_t write(const uint8_t *, size_t size)
+    {
+        return size;
+    }
+
+    void flush()
+    {}
+};
+
+extern HardwareSerial Serial;
+
+#endif //WINTERHOME_HOST_ARDUINO_H
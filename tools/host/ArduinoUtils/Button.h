@@ -0,0 +1,72 @@
+#ifndef WINTERHOME_HOST_ARDUINOUTILS_BUTTON_H
+#define WINTERHOME_HOST_ARDUINOUTILS_BUTTON_H
+
+// Замена Button и HandlerInterface из ArduinoUtils для сборки скетчей на хосте.
+// Кнопка нажата, пока уровень вывода отличается от уровня при создании. При
+// отпускании вызывается обработчик с наибольшим временем нажатия, не превышающим
+// длительность нажатия.
+
+#include <Arduino.h>
+
+#include <vector>
+
+class HandlerInterface {
+public:
+    virtual void call(uint8_t type, uint8_t idx) = 0;
+};
+
+class Button {
+    struct Handler {
+        HandlerInterface *handler;
+        uint8_t type;
+        uint16_t pressTime;
+    };
+
+    std::vector<Handler> handlers;
+    uint8_t pin;
+    uint8_t max;
+    int idle;
+    bool pressed = false;
+    unsigned long start = 0;
+
+public:
+    explicit Button(uint8_t pin, uint8_t n = 1, bool = true) : pin(pin), max(n)
+    {
+        idle = digitalRead(pin);
+    }
+
+    void addHandler(HandlerInterface *handler, uint8_t type = 0, uint16_t pressTime = 50)
+    {
+        if (handlers.size() < max) {
+            handlers.push_back(Handler{handler, type, pressTime});
+        }
+    }
+
+    void tick()
+    {
+        bool down = digitalRead(pin) != idle;
+        unsigned long m = millis();
+        if (down && !pressed) {
+            pressed = true;
+            start = m;
+            return;
+        }
+        if (down || !pressed) {
+            return;
+        }
+        pressed = false;
+        const Handler *best = nullptr;
+        uint8_t idx = 0;
+        for (uint8_t i = 0; i < handlers.size(); i++) {
+            if (m - start >= handlers[i].pressTime && (!best || handlers[i].pressTime > best->pressTime)) {
+                best = &handlers[i];
+                idx = i;
+            }
+        }
+        if (best) {
+            best->handler->call(best->type, idx);
+        }
+    }
+};
+
+#endif //WINTERHOME_HOST_ARDUINOUTILS_BUTTON_H
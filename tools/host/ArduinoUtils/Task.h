@@ -0,0 +1,72 @@
+#ifndef WINTERHOME_HOST_ARDUINOUTILS_TASK_H
+#define WINTERHOME_HOST_ARDUINOUTILS_TASK_H
+
+// Замена Task из ArduinoUtils (не путать со старой копией libraries/Task) для сборки
+// скетчей на хосте: n периодических и одноразовых вызовов по millis().
+
+#include <Arduino.h>
+
+#include <vector>
+
+class Task {
+    struct Callback {
+        void (*cb)();
+        bool repeat;
+        unsigned long last;
+        uint16_t timeout;
+    };
+
+    std::vector<Callback> callbacks;
+    uint8_t max;
+
+    void add(void (*cb)(), uint16_t t, bool repeat)
+    {
+        if (callbacks.size() < max) {
+            callbacks.push_back(Callback{cb, repeat, millis(), t});
+        }
+    }
+
+public:
+    explicit Task(uint8_t n) : max(n)
+    {}
+
+    void each(void (*cb)(), uint16_t t)
+    {
+        add(cb, t, true);
+    }
+
+    void one(void (*cb)(), uint16_t t)
+    {
+        add(cb, t, false);
+    }
+
+    void replace(void (*cb)(), uint16_t t)
+    {
+        for (Callback &c : callbacks) {
+            if (c.cb == cb) {
+                c.last = millis();
+                c.timeout = t;
+            }
+        }
+    }
+
+    void tick()
+    {
+        unsigned long m = millis();
+        for (size_t i = 0; i < callbacks.size(); i++) {
+            Callback &c = callbacks[i];
+            if (c.cb == nullptr || m - c.last < c.timeout) {
+                continue;
+            }
+            void (*cb)() = c.cb;
+            if (c.repeat) {
+                c.last += c.timeout;
+            } else {
+                c.cb = nullptr;
+            }
+            cb();
+        }
+    }
+};
+
+#endif //WINTERHOME_HOST_ARDUINOUTILS_TASK_H
@@ -0,0 +1,112 @@
+#ifndef WINTERHOME_HOST_EEPROMEX_H
+#define WINTERHOME_HOST_EEPROMEX_H
+
+// Замена EEPROMex на хосте: память и счетчики записей в hostBoard. Раскладка
+// чисел как на AVR: int - 2 байта, long и float - 4, младший байт первым.
+
+#include "Arduino.h"
+
+#define EEPROMSizeNano 1024
+
+class EEPROMClassEx {
+    void readBytes(int address, void *value, int size)
+    {
+        memcpy(value, hostBoard->eeprom + address, (size_t) size);
+    }
+
+    bool updateBytes(int address, const void *value, int size)
+    {
+        const uint8_t *bytes = (const uint8_t *) value;
+        for (int i = 0; i < size; i++) {
+            if (hostBoard->eeprom[address + i] != bytes[i]) {
+                hostBoard->eeprom[address + i] = bytes[i];
+                hostBoard->eepromWrites[address + i]++;
+            }
+        }
+        return true;
+    }
+
+public:
+    void setMemPool(int base, int)
+    {
+        hostBoard->eepromNext = base;
+    }
+
+    bool isReady()
+    {
+        return true;
+    }
+
+    int getAddress(int size)
+    {
+        int address = hostBoard->eepromNext;
+        hostBoard->eepromNext += size;
+        return address;
+    }
+
+    uint8_t readByte(int address)
+    {
+        return hostBoard->eeprom[address];
+    }
+
+    int readInt(int address)
+    {
+        int16_t value;
+        readBytes(address, &value, sizeof(value));
+        return value;
+    }
+
+    long readLong(int address)
+    {
+        int32_t value;
+        readBytes(address, &value, sizeof(value));
+        return value;
+    }
+
+    float readFloat(int address)
+    {
+        float value;
+        readBytes(address, &value, sizeof(value));
+        return value;
+    }
+
+    bool updateByte(int address, uint8_t value)
+    {
+        return updateBytes(address, &value, sizeof(value));
+    }
+
+    bool updateInt(int address, int value)
+    {
+        int16_t v = (int16_t) value;
+        return updateBytes(address, &v, sizeof(v));
+    }
+
+    bool updateLong(int address, long value)
+    {
+        int32_t v = (int32_t) value;
+        return updateBytes(address, &v, sizeof(v));
+    }
+
+    bool updateFloat(int address, float value)
+    {
+        return updateBytes(address, &value, sizeof(value));
+    }
+
+    template<class T>
+    int readBlock(int address, T &value)
+    {
+        readBytes(address, &value, sizeof(T));
+        return sizeof(T);
+    }
+
+    template<class T>
+    int updateBlock(int address, const T &value)
+    {
+        updateBytes(address, &value, sizeof(T));
+        return sizeof(T);
+    }
+};
+
+extern EEPROMClassEx EEPROM;
+
+#endif //WINTERHOME_HOST_EEPROMEX_H
@@ -0,0 +1,12 @@
+#include "Arduino.h"
+#include "EEPROMex.h"
+#include "LoRa.h"
+
+// Плата по умолчанию для тестов и бенчмарков с одним «устройством».
+static HostBoard defaultBoard;
+
+HostBoard *hostBoard = &defaultBoard;
+
+HardwareSerial Serial;
+LoRaClass LoRa;
+EEPROMClassEx EEPROM;
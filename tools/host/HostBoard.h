@@ -0,0 +1,243 @@
+#ifndef WINTERHOME_HOST_BOARD_H
+#define WINTERHOME_HOST_BOARD_H
+
+// Состояние одной платы Nano для сборки скетчей и библиотек на хосте.
+// Заглушки Arduino.h, LoRa.h, EEPROMex.h, U8g2lib.h, ServoEasing.h и
+// dht_nonblocking.h работают с платой hostBoard. tools/linksim.cpp держит по
+// плате на блок и переключает hostBoard перед вызовом loop() каждого скетча.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <string>
+
+struct HostBoard {
+    static const uint8_t PINS = 22;
+    static const uint16_t EEPROM_SIZE = 1024;
+    static const uint16_t PACKET_SIZE = 256;
+
+    // Режимы модема SX127x, которые различает модель.
+    static const uint8_t RADIO_SLEEP = 0;
+    static const uint8_t RADIO_STANDBY = 1;
+    static const uint8_t RADIO_RX = 2;
+    static const uint8_t RADIO_CAD = 3;
+
+    // Часы платы, мкс. Блокирующие вызовы (delay(), передача по радио) продвигают
+    // их сразу и копят ahead: пока он не отработан, плата занята и loop() не вызывается.
+    uint64_t micros = 0;
+    uint64_t ahead = 0;
+    // Уход частоты кварца относительно модели, ppm.
+    double ppm = 0;
+    double fraction = 0;
+
+    uint8_t pins[PINS]{};
+    // Число смен уровня каждого вывода.
+    unsigned long pinChanges[PINS]{};
+
+    uint8_t eeprom[EEPROM_SIZE];
+    // Число записей в каждую ячейку: update*() пишет только изменившиеся байты.
+    unsigned long eepromWrites[EEPROM_SIZE]{};
+    int eepromNext = 0;
+
+    // Передача: transmit получает кадр и возвращает его время в эфире, мкс.
+    std::function<uint32_t(const uint8_t *, uint8_t)> transmit;
+    uint8_t txBuffer[PACKET_SIZE]{};
+    uint16_t txLength = 0;
+
+    // Прием: модель кладет кадр в FIFO, parsePacket() переносит его в packet.
+    // Непрочитанный кадр затирается следующим, как в FIFO SX127x.
+    uint8_t fifo[PACKET_SIZE]{};
+    uint16_t fifoLength = 0;
+    bool fifoReady = false;
+    int fifoRssi = 0;
+    float fifoSnr = 0;
+    unsigned long overruns = 0;
+    uint8_t packet[PACKET_SIZE]{};
+    uint16_t packetLength = 0;
+    uint16_t packetRead = 0;
+    int packetRssi = 0;
+    float packetSnr = 0;
+
+    // Режим модема. Модель узнает о смене через radioChanged: кадр принимается, только
+    // если приемник слушал эфир с его преамбулы. FIFO очищается во сне.
+    uint8_t radioMode = RADIO_SLEEP;
+    std::function<void(uint8_t)> radioChanged;
+    // Настройки модема для длительности CAD.
+    uint8_t spreadingFactor = 7;
+    long bandwidth = 125000;
+
+    // CAD: модель отвечает, есть ли сейчас в эфире преамбула.
+    std::function<bool()> channelActivity;
+    // Обработчики DIO0 из LoRa.onReceive() и LoRa.onCadDone(). Прерывание по окончании
+    // CAD или приема вызывается перед следующим loop() (dispatch()).
+    void (*onReceive)(int) = nullptr;
+    void (*onCadDone)(bool) = nullptr;
+    bool cadPending = false;
+    bool cadDetected = false;
+    uint64_t cadDoneAt = 0;
+    bool rxDonePending = false;
+
+    // Замер DHT22 по запросу скетча; false - датчик не ответил.
+    std::function<bool(float &, float &)> sensor;
+
+    // Начало движения привода к angle, длительность ms.
+    std::function<void(int, unsigned long)> servo;
+
+    // Текст на экране: строки последней отрисовки через '\n'.
+    std::string display;
+
+    HostBoard()
+    {
+        memset(eeprom, 0xFF, sizeof(eeprom));
+    }
+
+    unsigned long millis() const
+    {
+        return (unsigned long) (micros / 1000);
+    }
+
+    // Блокирующий вызов длительностью us.
+    void block(uint64_t us)
+    {
+        micros += us;
+        ahead += us;
+    }
+
+    // Время модели ушло вперед на us. Возвращает true, если плата свободна и пора вызвать loop().
+    bool advance(uint64_t us)
+    {
+        double local = us * (1 + ppm / 1e6) + fraction;
+        uint64_t step = (uint64_t) local;
+        fraction = local - step;
+        if (ahead >= step) {
+            ahead -= step;
+            return false;
+        }
+        micros += step - ahead;
+        ahead = 0;
+        return true;
+    }
+
+    void setRadioMode(uint8_t mode)
+    {
+        if (mode == RADIO_SLEEP) {
+            fifoReady = false;
+        }
+        if (mode != RADIO_CAD) {
+            cadPending = false;
+        }
+        if (mode != RADIO_RX) {
+            rxDonePending = false;
+        }
+        if (mode != radioMode) {
+            radioMode = mode;
+            if (radioChanged) {
+                radioChanged(mode);
+            }
+        }
+    }
+
+    // Длительность CAD - около двух символов.
+    uint64_t cadMicros() const
+    {
+        return 2 * ((1000000ULL << spreadingFactor) / bandwidth);
+    }
+
+    void startCad()
+    {
+        setRadioMode(RADIO_CAD);
+        cadPending = true;
+        cadDetected = channelActivity && channelActivity();
+        cadDoneAt = micros + cadMicros();
+    }
+
+    void receive(const uint8_t *data, uint16_t length, int rssi, float snr)
+    {
+        if (fifoReady) {
+            overruns++;
+        }
+        memcpy(fifo, data, length);
+        fifoLength = length;
+        fifoRssi = rssi;
+        fifoSnr = snr;
+        fifoReady = true;
+        rxDonePending = onReceive != nullptr;
+    }
+
+    // Переносит принятый кадр из FIFO в packet, как LoRa.parsePacket(). Возвращает его длину или 0.
+    int readFifo()
+    {
+        if (!fifoReady) {
+            return 0;
+        }
+        fifoReady = false;
+        memcpy(packet, fifo, fifoLength);
+        packetLength = fifoLength;
+        packetRead = 0;
+        packetRssi = fifoRssi;
+        packetSnr = fifoSnr;
+        return packetLength;
+    }
+
+    // Прерывания DIO0, время которых пришло. Вызывается для текущей платы hostBoard.
+    void dispatch()
+    {
+        if (cadPending && micros >= cadDoneAt) {
+            // После CAD модем переходит в standby.
+            bool detected = cadDetected;
+            setRadioMode(RADIO_STANDBY);
+            if (onCadDone) {
+                onCadDone(detected);
+            }
+        }
+        if (rxDonePending) {
+            rxDonePending = false;
+            int length = readFifo();
+            if (length && onReceive) {
+                onReceive(length);
+            }
+        }
+    }
+
+    // Сброс: часы с нуля, выводы - входы без подтяжки, радио пустое. EEPROM сохраняется.
+    void reset()
+    {
+        micros = 0;
+        ahead = 0;
+        memset(pins, 0, sizeof(pins));
+        eepromNext = 0;
+        txLength = 0;
+        fifoReady = false;
+        packetLength = 0;
+        packetRead = 0;
+        onReceive = nullptr;
+        onCadDone = nullptr;
+        setRadioMode(RADIO_SLEEP);
+        display.clear();
+    }
+
+    unsigned long eepromTotalWrites() const
+    {
+        unsigned long total = 0;
+        for (unsigned long w : eepromWrites) {
+            total += w;
+        }
+        return total;
+    }
+
+    int eepromHottest() const
+    {
+        int hottest = 0;
+        for (int a = 1; a < EEPROM_SIZE; a++) {
+            if (eepromWrites[a] > eepromWrites[hottest]) {
+                hottest = a;
+            }
+        }
+        return hottest;
+    }
+};
+
+extern HostBoard *hostBoard;
+
+#endif //WINTERHOME_HOST_BOARD_H
@@ -0,0 +1,153 @@
+#ifndef WINTERHOME_HOST_LORA_H
+#define WINTERHOME_HOST_LORA_H
+
+// Замена библиотеки LoRa (sandeepmistry) на хосте. Передача блокирует плату на время
+// в эфире, которое возвращает hostBoard->transmit; прием читает FIFO платы.
+// Режимы модема (сон, standby, прием, CAD) и прерывания DIO0 ведет плата, см. HostBoard.
+// Остальные настройки модема принимаются без действия: время в эфире модель считает по RadioProfile.
+
+#include "Arduino.h"
+
+class LoRaClass {
+public:
+    int begin(long)
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_STANDBY);
+        return 1;
+    }
+
+    void setTxPower(int, int = 1)
+    {}
+
+    void setSpreadingFactor(int sf)
+    {
+        hostBoard->spreadingFactor = (uint8_t) sf;
+    }
+
+    void setSignalBandwidth(long bw)
+    {
+        hostBoard->bandwidth = bw;
+    }
+
+    void setCodingRate4(int)
+    {}
+
+    void setPreambleLength(long)
+    {}
+
+    void setSyncWord(int)
+    {}
+
+    void enableCrc()
+    {}
+
+    int beginPacket(int = 0)
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_STANDBY);
+        hostBoard->txLength = 0;
+        return 1;
+    }
+
+    // После передачи модем остается в standby.
+    int endPacket(bool = false)
+    {
+        if (hostBoard->transmit) {
+            hostBoard->block(hostBoard->transmit(hostBoard->txBuffer, (uint8_t) hostBoard->txLength));
+        }
+        hostBoard->txLength = 0;
+        return 1;
+    }
+
+    size_t write(uint8_t byte)
+    {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t *data, size_t size)
+    {
+        size_t room = HostBoard::PACKET_SIZE - 1 - hostBoard->txLength;
+        if (size > room) {
+            size = room;
+        }
+        memcpy(hostBoard->txBuffer + hostBoard->txLength, data, size);
+        hostBoard->txLength += (uint16_t) size;
+        return size;
+    }
+
+    // Вне приема, как и библиотека, включает прием одного кадра.
+    int parsePacket(int = 0)
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_RX);
+        return hostBoard->readFifo();
+    }
+
+    int available()
+    {
+        return hostBoard->packetLength - hostBoard->packetRead;
+    }
+
+    int read()
+    {
+        if (!available()) {
+            return -1;
+        }
+        return hostBoard->packet[hostBoard->packetRead++];
+    }
+
+    size_t readBytes(uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && available()) {
+            buffer[n++] = (uint8_t) read();
+        }
+        return n;
+    }
+
+    int packetRssi()
+    {
+        return hostBoard->packetRssi;
+    }
+
+    float packetSnr()
+    {
+        return hostBoard->packetSnr;
+    }
+
+    void onReceive(void (*callback)(int))
+    {
+        hostBoard->onReceive = callback;
+    }
+
+    void onCadDone(void (*callback)(bool))
+    {
+        hostBoard->onCadDone = callback;
+    }
+
+    // Передача блокирующая, TxDone не нужен.
+    void onTxDone(void (*)())
+    {}
+
+    void receive(int = 0)
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_RX);
+    }
+
+    void channelActivityDetection()
+    {
+        hostBoard->startCad();
+    }
+
+    void idle()
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_STANDBY);
+    }
+
+    void sleep()
+    {
+        hostBoard->setRadioMode(HostBoard::RADIO_SLEEP);
+    }
+};
+
+extern LoRaClass LoRa;
+
+#endif //WINTERHOME_HOST_LORA_H
@@ -0,0 +1,78 @@
+#ifndef WINTERHOME_HOST_SERVOEASING_H
+#define WINTERHOME_HOST_SERVOEASING_H
+
+// Замена ServoEasing на хосте: равномерное движение с заданной скоростью по часам
+// платы. О начале каждого движения сообщается модели через hostBoard->servo.
+
+#include "Arduino.h"
+
+#define START_UPDATE_BY_INTERRUPT true
+#define EASE_CUBIC_IN_OUT 1
+
+class ServoEasing {
+    int from = 0;
+    int target = 0;
+    uint16_t speed = 0;
+    unsigned long start = 0;
+    unsigned long duration = 0;
+
+public:
+    uint8_t attach(int pin)
+    {
+        return attach(pin, 90);
+    }
+
+    uint8_t attach(int, int angle)
+    {
+        write(angle);
+        return 0;
+    }
+
+    void setSpeed(uint16_t degreesPerSecond)
+    {
+        speed = degreesPerSecond;
+    }
+
+    void setEasingType(uint8_t)
+    {}
+
+    // Новая цель во время движения: привод продолжает с текущего положения.
+    bool startEaseTo(int angle, uint16_t degreesPerSecond = 0, bool = START_UPDATE_BY_INTERRUPT)
+    {
+        uint16_t s = degreesPerSecond ? degreesPerSecond : speed;
+        from = getCurrentAngle();
+        target = angle;
+        start = millis();
+        duration = s ? (unsigned long) abs(target - from) * 1000 / s : 0;
+        if (hostBoard->servo) {
+            hostBoard->servo(target, duration);
+        }
+        return true;
+    }
+
+    bool update()
+    {
+        return !isMoving();
+    }
+
+    bool isMoving()
+    {
+        return millis() - start < duration;
+    }
+
+    int getCurrentAngle()
+    {
+        if (!isMoving()) {
+            return target;
+        }
+        return from + (int) ((long) (target - from) * (long) (millis() - start) / (long) duration);
+    }
+
+    void write(int angle)
+    {
+        from = target = angle;
+        duration = 0;
+    }
+};
+
+#endif //WINTERHOME_HOST_SERVOEASING_H
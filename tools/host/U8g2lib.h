@@ -0,0 +1,110 @@
+#ifndef WINTERHOME_HOST_U8G2LIB_H
+#define WINTERHOME_HOST_U8G2LIB_H
+
+// Замена U8g2 на хосте для двух экранов блоков: графика не рисуется, выведенный
+// текст попадает в hostBoard->display, чтобы модель видела, что показывает блок.
+
+#include "Arduino.h"
+
+#include <string>
+
+#define U8G2_R0 0
+
+// Шрифты только различаются по адресу.
+static const uint8_t u8g2_font_mercutio_basic_nbp_t_all[1] = {};
+static const uint8_t u8g2_font_logisoso16_tf[1] = {};
+static const uint8_t u8x8_font_pxplusibmcgathin_f[1] = {};
+static const uint8_t u8x8_font_px437wyse700b_2x2_f[1] = {};
+
+// Полнобуферный U8g2: текст копится в буфере и появляется на экране в sendBuffer().
+class U8G2_SH1106_128X64_NONAME_F_4W_HW_SPI {
+    std::string buffer;
+
+public:
+    U8G2_SH1106_128X64_NONAME_F_4W_HW_SPI(int, uint8_t, uint8_t, uint8_t)
+    {}
+
+    void begin()
+    {}
+
+    void clearBuffer()
+    {
+        buffer.clear();
+    }
+
+    void sendBuffer()
+    {
+        hostBoard->display = buffer;
+    }
+
+    void setFont(const uint8_t *)
+    {}
+
+    int drawUTF8(int, int, const char *text)
+    {
+        buffer += text;
+        buffer += '\n';
+        return (int) strlen(text) * 6;
+    }
+
+    void drawBox(int, int, int, int)
+    {}
+
+    void drawFrame(int, int, int, int)
+    {}
+
+    void drawPixel(int, int)
+    {}
+
+    void drawHLine(int, int, int)
+    {}
+
+    void drawVLine(int, int, int)
+    {}
+
+    void drawLine(int, int, int, int)
+    {}
+
+    void setDrawColor(uint8_t)
+    {}
+
+    void setFontMode(uint8_t)
+    {}
+};
+
+// U8x8 пишет прямо в экран.
+class U8X8_SH1106_128X64_NONAME_4W_HW_SPI {
+public:
+    U8X8_SH1106_128X64_NONAME_4W_HW_SPI(uint8_t, uint8_t, uint8_t)
+    {}
+
+    void begin()
+    {}
+
+    void clearDisplay()
+    {
+        hostBoard->display.clear();
+    }
+
+    void setFont(const uint8_t *)
+    {}
+
+    void drawUTF8(int, int, const char *text)
+    {
+        hostBoard->display += text;
+        hostBoard->display += '\n';
+    }
+
+    void setInverseFont(bool)
+    {}
+
+    void setPowerSave(uint8_t)
+    {}
+
+    uint8_t getCols()
+    {
+        return 16;
+    }
+};
+
+#endif //WINTERHOME_HOST_U8G2LIB_H
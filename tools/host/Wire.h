@@ -0,0 +1,6 @@
+#ifndef WINTERHOME_HOST_WIRE_H
+#define WINTERHOME_HOST_WIRE_H
+
+// Заглушка Wire.h: скетчи подключают ее, но I2C не используют.
+
+#endif //WINTERHOME_HOST_WIRE_H
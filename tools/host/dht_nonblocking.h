@@ -0,0 +1,34 @@
+#ifndef WINTERHOME_HOST_DHT_NONBLOCKING_H
+#define WINTERHOME_HOST_DHT_NONBLOCKING_H
+
+// Замена DHT_nonblocking на хосте: значения дает hostBoard->sensor. DHT22 отвечает
+// не чаще раза в 2 с, более частые вызовы measure() возвращают false.
+
+#include "Arduino.h"
+
+#define DHT_TYPE_11 0
+#define DHT_TYPE_21 1
+#define DHT_TYPE_22 2
+
+class DHT_nonblocking {
+    static const unsigned long INTERVAL = 2000;
+
+    bool measured = false;
+    unsigned long last = 0;
+
+public:
+    DHT_nonblocking(uint8_t, uint8_t)
+    {}
+
+    bool measure(float *temperature, float *humidity)
+    {
+        if (measured && millis() - last < INTERVAL) {
+            return false;
+        }
+        measured = true;
+        last = millis();
+        return hostBoard->sensor && hostBoard->sensor(*temperature, *humidity);
+    }
+};
+
+#endif //WINTERHOME_HOST_DHT_NONBLOCKING_H
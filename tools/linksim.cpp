@@ -0,0 +1,778 @@
+// Модель связки домашнего и удаленного блока на хосте. В один процесс собраны сами
+// скетчи home/src/main.cpp и remote/src/main.cpp (linksim/home.cpp, linksim/remote.cpp)
+// с заглушками периферии из host/: у каждого блока своя плата HostBoard с часами,
+// выводами, EEPROM и радио. Модель отвечает только за окружение: эфир между
+// блоками, помещение с обогревом и датчиком DHT22, кнопки и энкодер.
+//
+// Сборка на хосте:
+//   cmake -S . -B build -DWINTERHOME_HOST_TOOLS=ON && cmake --build build --target linksim
+// linksim_lowpower - те же скетчи с профилем RADIO_433_SF8_LOW_POWER: радио спит
+// и просыпается по CAD, кадр принимается, только если приемник успел включить
+// прием до конца преамбулы (в статистике - «not listening»).
+//
+// Использование:
+//   linksim [--days N] [--seed N] [--step MS] [--loss P] [--snr DB] [--snr-sigma DB]
+//           [--corrupt P] [--presses N] [--spikes P] [--script файл]
+//
+// --days N       длительность модели в сутках (по умолчанию 7)
+// --seed N       начальное значение генератора, при одинаковых параметрах результат повторяется
+// --step MS      шаг вызова loop() обоих скетчей (по умолчанию 10 мс)
+// --loss P       вероятность потери кадра в канале
+// --snr DB       средний SNR на приемнике и его разброс --snr-sigma, кадры ниже порога SF теряются
+// --corrupt P    вероятность искажения байта кадра (отбрасывается проверкой формата и подписи)
+// --presses N    случайных нажатий вверх/вниз на домашнем блоке в сутки, если нет сценария
+// --spikes P     вероятность выброса в замере DHT22
+// --script файл  сценарий, по строке на событие: "<секунда> <команда> [значение]", команды:
+//                up, down, up-long, down-long - кнопки домашнего блока;
+//                button - кнопка удаленного; encoder N - N щелчков энкодера удаленного
+//                (на основном экране двигают клапан, на экранах настройки - уставки);
+//                reboot-home, reboot-remote - перезапуск блока (EEPROM сохраняется);
+//                outside T - средняя уличная температура; loss P; snr DB
+//
+// Задержки отсчитываются от отпускания кнопки, когда скетч получает нажатие:
+// команда -> начало движения клапана и команда -> первая телеметрия на домашнем
+// блоке после остановки клапана. Нажатие, на которое клапан не сдвинулся за 30 с
+// или до конца модели, считается без реакции. «Нет сигнала» и «ошибка датчика»
+// считаются по тексту на экране домашнего блока. Кадр без искажений, который
+// приемник отбросит по подписи или счетчику, считается отдельно от доставленных.
+
+#include <Arduino.h>
+#include <Auth.h>
+#include <Frame.h>
+#include <Link.h>
+#include <RadioProfile.h>
+
+#include "linksim/AuthKey.h"
+#include "linksim/Sketches.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint64_t SECOND = 1000000;
+const uint64_t HOUR = 3600 * SECOND;
+const uint64_t DAY = 24 * HOUR;
+
+// Порог демодуляции SX1278 для SF7..SF12, дБ.
+const double SNR_LIMIT[] = {-7.5, -10, -12.5, -15, -17.5, -20};
+// Символов преамбулы, которые приемник должен услышать, чтобы захватить кадр.
+const uint32_t LOCK_SYMBOLS = 5;
+// Преамбула в эфире, мкс: preamble + 4.25 символа.
+const uint64_t PREAMBLE_MICROS = (4ULL * RADIO.preamble + 17) * RADIO.symbolMicros() / 4;
+const uint64_t NOT_LISTENING = UINT64_MAX;
+
+// Идентификаторы блоков в подписи кадров (NODE_ID скетчей).
+const uint8_t HOME_ID = 'H';
+const uint8_t REMOTE_ID = 'R';
+
+// Выводы скетчей.
+const uint8_t HOME_UP = A1;
+const uint8_t HOME_DOWN = A0;
+const uint8_t REMOTE_BUTTON = A7;
+const uint8_t REMOTE_ENCODER_1 = A2;
+const uint8_t REMOTE_ENCODER_2 = A3;
+const uint8_t REMOTE_R1 = A0;
+const uint8_t REMOTE_R2 = A1;
+
+// Короткое и длинное нажатие (HomeController::LONG_PRESS 1500 мс), мс.
+const unsigned long SHORT_PRESS = 150;
+const unsigned long LONG_PRESS = 2000;
+// Щелчок энкодера без ускорения AcceleratedEncoder, мс.
+const unsigned long DETENT = 200;
+// Нажатие, на которое клапан не сдвинулся за это время, считается потерянным.
+const uint64_t NO_REACTION = 30 * SECOND;
+// Ресурс ячейки EEPROM ATmega328, циклов записи.
+const double EEPROM_ENDURANCE = 100000;
+
+// Текст экрана домашнего блока, см. HomeController::render().
+const char *const NO_SIGNAL_TEXT = "нет сигнала!";
+const char *const SENSOR_ERROR_TEXT = "ошибка датчика";
+
+struct Options {
+    double days = 7;
+    uint32_t seed = 1;
+    double step = 10;
+    double loss = 0.01;
+    double snr = 5;
+    double snrSigma = 3;
+    double corrupt = 0.001;
+    double presses = 24;
+    double spikes = 0.01;
+    const char *script = nullptr;
+};
+
+class Sim {
+    struct Event {
+        uint64_t time;
+        uint64_t seq;
+        std::function<void()> action;
+
+        bool operator>(const Event &other) const
+        {
+            return time != other.time ? time > other.time : seq > other.seq;
+        }
+    };
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> queue;
+    uint64_t seq = 0;
+
+public:
+    // Глобальное время модели, мкс.
+    uint64_t now = 0;
+    std::mt19937 rng;
+
+    explicit Sim(uint32_t seed) : rng(seed)
+    {}
+
+    void at(uint64_t time, std::function<void()> action)
+    {
+        queue.push(Event{std::max(time, now), seq++, std::move(action)});
+    }
+
+    void run(uint64_t end)
+    {
+        while (!queue.empty() && queue.top().time <= end) {
+            Event e = queue.top();
+            queue.pop();
+            now = e.time;
+            e.action();
+        }
+        now = end;
+    }
+
+    double uniform()
+    {
+        return std::uniform_real_distribution<double>(0, 1)(rng);
+    }
+
+    double normal(double mean, double sigma)
+    {
+        return std::normal_distribution<double>(mean, sigma)(rng);
+    }
+};
+
+class Percentiles {
+    std::vector<double> values;
+
+public:
+    void add(double v)
+    {
+        values.push_back(v);
+    }
+
+    size_t size() const
+    {
+        return values.size();
+    }
+
+    void print(const char *name, double scale, const char *unit)
+    {
+        if (values.empty()) {
+            printf("  %-22s нет данных\n", name);
+            return;
+        }
+        std::sort(values.begin(), values.end());
+        double sum = 0;
+        for (double v : values) {
+            sum += v;
+        }
+        auto at = [this](double q) {
+            return values[std::min(values.size() - 1, (size_t) (q * values.size()))];
+        };
+        printf("  %-22s n %-6zu mean %8.2f  p50 %8.2f  p95 %8.2f  max %8.2f %s\n", name, values.size(),
+               sum / values.size() / scale, at(0.5) / scale, at(0.95) / scale, values.back() / scale, unit);
+    }
+};
+
+struct LinkStats {
+    unsigned long sent = 0;
+    unsigned long delivered = 0;
+    unsigned long lost = 0;
+    unsigned long weak = 0;
+    unsigned long busy = 0;
+    // Приемник не слушал эфир с начала преамбулы: спал или не успел проснуться по CAD.
+    unsigned long asleep = 0;
+    unsigned long corrupted = 0;
+    // Кадр дошел без искажений, но приемник не принял подпись или счетчик.
+    unsigned long rejected = 0;
+    uint64_t airtime = 0;
+};
+
+struct Channel {
+    double loss;
+    double snr;
+    double snrSigma;
+    double corrupt;
+};
+
+// Блок: плата и скетч, который на ней работает.
+struct Board {
+    const char *name;
+    void (*setup)();
+    void (*loop)();
+    HostBoard hw;
+    Board *peer = nullptr;
+    LinkStats stats;
+    uint64_t bootedAt = 0;
+    bool telemetrySent = false;
+
+    // Последние передачи в глобальном времени для проверки полудуплекса и CAD
+    // приемника, с SNR кадра на приемнике.
+    uint64_t txStart[4]{};
+    uint64_t txEnd[4]{};
+    double txSnr[4]{};
+    uint8_t txNext = 0;
+    // С какого момента модем в режиме приема.
+    uint64_t rxSince = NOT_LISTENING;
+
+    // Проверка подписи принятых кадров, как в RadioLink скетча: после перезагрузки
+    // счет продолжается с блока последнего принятого кадра, сохраненного в EEPROM.
+    Auth verifier;
+    uint32_t rxLeaseStored = 0xFFFFFFFF;
+
+    Board(const char *name, uint8_t id, uint8_t peerId, void (*setup)(), void (*loop)(), double ppm)
+            : name(name), setup(setup), loop(loop), verifier(AUTH_KEY, id, peerId)
+    {
+        hw.ppm = ppm;
+    }
+
+    void select()
+    {
+        hostBoard = &hw;
+    }
+
+    void boot(uint64_t now)
+    {
+        hw.reset();
+        bootedAt = now;
+        telemetrySent = false;
+        verifier.begin(0, rxLeaseStored);
+        select();
+        setup();
+    }
+
+    void step(uint64_t us)
+    {
+        if (hw.advance(us)) {
+            select();
+            hw.dispatch();
+            loop();
+        }
+    }
+
+    bool transmitting(uint64_t start, uint64_t end) const
+    {
+        for (uint8_t i = 0; i < 4; i++) {
+            if (txStart[i] < end && txEnd[i] > start) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // В эфире преамбула кадра, который приемник различит.
+    bool preambleOnAir(uint64_t now) const
+    {
+        for (uint8_t i = 0; i < 4; i++) {
+            if (txStart[i] <= now && now < txStart[i] + PREAMBLE_MICROS
+                && txSnr[i] >= SNR_LIMIT[RADIO.spreadingFactor - 7]) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+class Model {
+    // Помещение: постоянная времени и нагрев от каждого реле, °C/ч.
+    static constexpr double ROOM_TAU_HOURS = 6;
+    static constexpr double HEATER_POWER = 2;
+
+    double roomTemp = 4;
+    uint64_t thermalAt = 0;
+    bool r1 = false;
+    bool r2 = false;
+
+    uint64_t lastTelemetry = 0;
+    bool telemetryReceived = false;
+
+    // Отпущенные нажатия вверх/вниз, клапан по ним еще не двигался.
+    std::vector<uint64_t> pending;
+    // Нажатия текущего движения клапана, ждут телеметрии после остановки.
+    std::vector<uint64_t> moving;
+    uint64_t settleAt = 0;
+
+    double outside() const
+    {
+        // Суточный ход: минимум к 3 часам, максимум к 15.
+        double hours = (double) sim.now / HOUR;
+        return outsideMean + 5 * sin(2 * M_PI * (hours - 9) / 24);
+    }
+
+    void updateRoom()
+    {
+        double dt = (double) (sim.now - thermalAt) / HOUR;
+        thermalAt = sim.now;
+        double heat = (r1 ? HEATER_POWER : 0) + (r2 ? HEATER_POWER : 0);
+        double equilibrium = outside() + heat * ROOM_TAU_HOURS;
+        roomTemp = equilibrium + (roomTemp - equilibrium) * exp(-dt / ROOM_TAU_HOURS);
+        if (r1) {
+            r1On += dt;
+        }
+        if (r2) {
+            r2On += dt;
+        }
+        roomMin = std::min(roomMin, roomTemp);
+        roomMax = std::max(roomMax, roomTemp);
+    }
+
+    // Реле удаленного блока по уровню выводов (relayMode HIGH).
+    void sampleRelays()
+    {
+        updateRoom();
+        bool on1 = remote.hw.pins[REMOTE_R1] == HIGH;
+        bool on2 = remote.hw.pins[REMOTE_R2] == HIGH;
+        r1Cycles += on1 && !r1;
+        r2Cycles += on2 && !r2;
+        r1 = on1;
+        r2 = on2;
+    }
+
+    bool measure(float &temp, float &hum)
+    {
+        updateRoom();
+        double value = roomTemp + sim.normal(0, 0.05);
+        if (sim.uniform() < spikes) {
+            dhtSpikes++;
+            // Выброс в пределах диапазона DHT22 проходит проверку скетча и отсекается медианой.
+            value = roomTemp + (sim.uniform() < 0.5 ? -1 : 1) * (10 + 20 * sim.uniform());
+            value = std::max(-40.0, std::min(80.0, value));
+        }
+        temp = (float) value;
+        hum = (float) (60 + sim.normal(0, 0.5));
+        return true;
+    }
+
+    uint32_t transmit(Board &from, const uint8_t *data, uint8_t length)
+    {
+        uint32_t airtime = RADIO.timeOnAir(length);
+        // Второй кадр за один loop() уходит после первого: плата уже ушла вперед на ahead.
+        uint64_t start = sim.now + from.hw.ahead;
+        uint64_t end = start + airtime;
+        double snr = sim.normal(channel.snr, channel.snrSigma);
+        from.txStart[from.txNext] = start;
+        from.txEnd[from.txNext] = end;
+        from.txSnr[from.txNext] = snr;
+        from.txNext = (from.txNext + 1) % 4;
+        from.stats.sent++;
+        from.stats.airtime += airtime;
+
+        if (&from == &remote && !from.telemetrySent && Frame::validate(data, length) == Frame::TYPE_TELEMETRY) {
+            from.telemetrySent = true;
+            bootToTelemetry.add((double) (start - from.bootedAt));
+        }
+        std::vector<uint8_t> packet(data, data + length);
+        sim.at(end, [this, &from, packet, start, end, snr]() {
+            deliver(from, packet, start, end, snr);
+        });
+        return airtime;
+    }
+
+    void deliver(Board &from, std::vector<uint8_t> packet, uint64_t start, uint64_t end, double snr)
+    {
+        Board &to = *from.peer;
+        LinkStats &link = from.stats;
+        if (to.transmitting(start, end)) {
+            link.busy++;
+            return;
+        }
+        if (to.rxSince == NOT_LISTENING || to.rxSince + LOCK_SYMBOLS * RADIO.symbolMicros() > start + PREAMBLE_MICROS) {
+            link.asleep++;
+            return;
+        }
+        if (snr < SNR_LIMIT[RADIO.spreadingFactor - 7]) {
+            link.weak++;
+            return;
+        }
+        if (sim.uniform() < channel.loss) {
+            link.lost++;
+            return;
+        }
+        bool corrupted = false;
+        for (uint8_t &b : packet) {
+            if (sim.uniform() < channel.corrupt) {
+                b ^= (uint8_t) (1 << (sim.rng() % 8));
+                corrupted = true;
+            }
+        }
+        const uint8_t *data = packet.data();
+        uint8_t length = (uint8_t) packet.size();
+        uint8_t type = Frame::TYPE_INVALID;
+        if (corrupted) {
+            link.corrupted++;
+        } else if ((type = Link::check(&to.verifier, data, length)) == Frame::TYPE_INVALID) {
+            link.rejected++;
+        } else {
+            link.delivered++;
+            to.rxLeaseStored = to.verifier.getRxLease();
+        }
+        // SNR в регистре SX127x - четверти дБ.
+        to.hw.receive(data, length, (int) (-110 + snr), (float) (round(snr * 4) / 4));
+
+        if (&to == &home && type == Frame::TYPE_TELEMETRY) {
+            telemetryAtHome(*Frame::view<Frame::Telemetry>(data));
+        }
+    }
+
+    void telemetryAtHome(const Frame::Telemetry &t)
+    {
+        lastTelemetry = sim.now;
+        telemetryReceived = true;
+        if (t.errCode == 0) {
+            filterError = std::max(filterError, fabs(t.temp / 100.0 - roomTemp));
+        }
+        if (!moving.empty() && sim.now >= settleAt) {
+            for (uint64_t pressed : moving) {
+                ackLatency.add((double) (sim.now - pressed));
+            }
+            moving.clear();
+        }
+    }
+
+    // Нажатия, на которые клапан не сдвинулся за NO_REACTION, больше не ждут движения.
+    void expirePresses()
+    {
+        while (!pending.empty() && sim.now - pending.front() > NO_REACTION) {
+            unanswered++;
+            pending.erase(pending.begin());
+        }
+    }
+
+    void servoMoved(unsigned long ms)
+    {
+        servoMoves++;
+        expirePresses();
+        for (uint64_t pressed : pending) {
+            servoLatency.add((double) (sim.now - pressed));
+            moving.push_back(pressed);
+        }
+        pending.clear();
+        settleAt = sim.now + ms * 1000ULL;
+    }
+
+    // Смена режима модема и CAD - в момент по часам платы: блокирующие вызовы
+    // ушли вперед на ahead относительно времени модели.
+    void attachRadio(Board &board)
+    {
+        board.hw.radioChanged = [this, &board](uint8_t mode) {
+            board.rxSince = mode == HostBoard::RADIO_RX ? sim.now + board.hw.ahead : NOT_LISTENING;
+        };
+        board.hw.channelActivity = [this, &board]() {
+            return board.peer->preambleOnAir(sim.now + board.hw.ahead);
+        };
+    }
+
+    // Раз в секунду: помещение, реле и что показывает домашний блок.
+    void sample()
+    {
+        sampleRelays();
+        expirePresses();
+        if (telemetryReceived) {
+            freshness.add((double) (sim.now - lastTelemetry));
+        }
+        if (home.hw.display.find(NO_SIGNAL_TEXT) != std::string::npos) {
+            noSignalSeconds++;
+        }
+        if (home.hw.display.find(SENSOR_ERROR_TEXT) != std::string::npos) {
+            sensorErrorSeconds++;
+        }
+        sim.at(sim.now + SECOND, [this]() {
+            sample();
+        });
+    }
+
+public:
+    Sim sim;
+    Channel channel;
+    // Уход кварцев блоков в противоположные стороны.
+    Board home{"home", HOME_ID, REMOTE_ID, ::home::setup, ::home::loop, 20};
+    Board remote{"remote", REMOTE_ID, HOME_ID, ::remote::setup, ::remote::loop, -30};
+
+    double outsideMean = -5;
+    double spikes = 0;
+    unsigned long presses = 0;
+    unsigned long unanswered = 0;
+    // Из них нажатия, которые к концу модели еще ждали движения клапана.
+    unsigned long unansweredAtEnd = 0;
+    unsigned long servoMoves = 0;
+    unsigned long r1Cycles = 0;
+    unsigned long r2Cycles = 0;
+    double r1On = 0;
+    double r2On = 0;
+    double roomMin = 1e9;
+    double roomMax = -1e9;
+    double filterError = 0;
+    unsigned long dhtSpikes = 0;
+    unsigned long noSignalSeconds = 0;
+    unsigned long sensorErrorSeconds = 0;
+    unsigned long reboots = 0;
+    Percentiles servoLatency;
+    Percentiles ackLatency;
+    Percentiles freshness;
+    Percentiles bootToTelemetry;
+
+    Model(uint32_t seed, const Channel &channel) : sim(seed), channel(channel)
+    {
+        home.peer = &remote;
+        remote.peer = &home;
+        attachRadio(home);
+        attachRadio(remote);
+        home.hw.transmit = [this](const uint8_t *data, uint8_t length) {
+            return transmit(home, data, length);
+        };
+        remote.hw.transmit = [this](const uint8_t *data, uint8_t length) {
+            return transmit(remote, data, length);
+        };
+        remote.hw.sensor = [this](float &temp, float &hum) {
+            return measure(temp, hum);
+        };
+        remote.hw.servo = [this](int, unsigned long ms) {
+            servoMoved(ms);
+        };
+    }
+
+    void start()
+    {
+        home.boot(sim.now);
+        remote.boot(sim.now);
+        sample();
+    }
+
+    void reboot(Board &board)
+    {
+        reboots++;
+        board.boot(sim.now);
+    }
+
+    // Нажатие кнопки: уровень вывода меняется на ms, скетч видит нажатие при отпускании.
+    void press(Board &board, uint8_t pin, unsigned long ms, bool command)
+    {
+        board.hw.pins[pin] ^= 1;
+        sim.at(sim.now + ms * 1000ULL, [this, &board, pin, command]() {
+            board.hw.pins[pin] ^= 1;
+            if (command) {
+                presses++;
+                pending.push_back(sim.now);
+            }
+        });
+    }
+
+    // Щелчки энкодера удаленного блока, по четыре перехода с прерыванием на каждый.
+    void turn(int detents)
+    {
+        static const uint8_t CW[] = {2, 3, 1, 0};
+        static const uint8_t CCW[] = {1, 3, 2, 0};
+        const uint8_t *sequence = detents > 0 ? CW : CCW;
+        for (int d = 0; d < abs(detents); d++) {
+            for (uint8_t i = 0; i < 4; i++) {
+                uint8_t pins = sequence[i];
+                sim.at(sim.now + (d * 4 + i + 1) * DETENT * 250ULL, [this, pins]() {
+                    remote.hw.pins[REMOTE_ENCODER_1] = pins & 1;
+                    remote.hw.pins[REMOTE_ENCODER_2] = pins >> 1;
+                    remote.select();
+                    ::remote::PCINT1_vect();
+                });
+            }
+        }
+    }
+
+    void run(uint64_t end, uint64_t step)
+    {
+        while (sim.now < end) {
+            sim.run(sim.now + step);
+            home.step(step);
+            remote.step(step);
+        }
+        sampleRelays();
+        expirePresses();
+        unansweredAtEnd = pending.size();
+        unanswered += pending.size();
+        pending.clear();
+    }
+};
+
+bool loadScript(const char *path, Model &m)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    char line[128];
+    unsigned n = 0;
+    while (fgets(line, sizeof(line), f)) {
+        n++;
+        double seconds = 0;
+        double value = 0;
+        char command[16]{};
+        if (line[0] == '#' || sscanf(line, "%lf %15s %lf", &seconds, command, &value) < 2) {
+            continue;
+        }
+        uint64_t t = (uint64_t) (seconds * SECOND);
+        std::function<void()> action;
+        if (strcmp(command, "up") == 0) {
+            action = [&m]() { m.press(m.home, HOME_UP, SHORT_PRESS, true); };
+        } else if (strcmp(command, "down") == 0) {
+            action = [&m]() { m.press(m.home, HOME_DOWN, SHORT_PRESS, true); };
+        } else if (strcmp(command, "up-long") == 0) {
+            action = [&m]() { m.press(m.home, HOME_UP, LONG_PRESS, false); };
+        } else if (strcmp(command, "down-long") == 0) {
+            action = [&m]() { m.press(m.home, HOME_DOWN, LONG_PRESS, false); };
+        } else if (strcmp(command, "button") == 0) {
+            action = [&m]() { m.press(m.remote, REMOTE_BUTTON, SHORT_PRESS, false); };
+        } else if (strcmp(command, "encoder") == 0) {
+            action = [&m, value]() { m.turn((int) value); };
+        } else if (strcmp(command, "reboot-home") == 0) {
+            action = [&m]() { m.reboot(m.home); };
+        } else if (strcmp(command, "reboot-remote") == 0) {
+            action = [&m]() { m.reboot(m.remote); };
+        } else if (strcmp(command, "outside") == 0) {
+            action = [&m, value]() { m.outsideMean = value; };
+        } else if (strcmp(command, "loss") == 0) {
+            action = [&m, value]() { m.channel.loss = value; };
+        } else if (strcmp(command, "snr") == 0) {
+            action = [&m, value]() { m.channel.snr = value; };
+        } else {
+            fprintf(stderr, "%s:%u: unknown command %s\n", path, n, command);
+            fclose(f);
+            return false;
+        }
+        m.sim.at(t, action);
+    }
+    fclose(f);
+    return true;
+}
+
+// Случайные нажатия в дневные часы, пачками по 1..3.
+void randomPresses(const Options &o, Model &m)
+{
+    unsigned long total = (unsigned long) (o.presses * o.days);
+    for (unsigned long i = 0; i < total; i++) {
+        uint64_t day = (uint64_t) (m.sim.uniform() * o.days);
+        uint64_t t = day * DAY + 7 * HOUR + (uint64_t) (m.sim.uniform() * 16 * HOUR);
+        uint8_t pin = m.sim.uniform() < 0.5 ? HOME_UP : HOME_DOWN;
+        unsigned burst = 1 + m.sim.rng() % 3;
+        for (unsigned j = 0; j < burst; j++) {
+            m.sim.at(t + j * 400000, [&m, pin]() { m.press(m.home, pin, SHORT_PRESS, true); });
+        }
+    }
+}
+
+void printLink(const Board &from)
+{
+    const LinkStats &s = from.stats;
+    unsigned long missed = s.lost + s.weak + s.busy + s.asleep + s.corrupted + s.rejected;
+    printf("  %6s->%-6s sent %6lu  delivered %6lu  missed %5lu (loss %lu, snr %lu, half-duplex %lu, not listening %lu,"
+           " corrupted %lu, auth rejected %lu)  overrun %lu  airtime %.1f s\n",
+           from.name, from.peer->name, s.sent, s.delivered, missed, s.lost, s.weak, s.busy, s.asleep, s.corrupted,
+           s.rejected, from.peer->hw.overruns, s.airtime / 1e6);
+}
+
+void printEeprom(const Board &board, double days)
+{
+    int hottest = board.hw.eepromHottest();
+    unsigned long writes = board.hw.eepromWrites[hottest];
+    printf("  %-6s writes %lu, hottest cell %d: %lu", board.name, board.hw.eepromTotalWrites(), hottest, writes);
+    if (writes) {
+        printf(" (%.1f years to %.0f cycles)", EEPROM_ENDURANCE / (writes / days) / 365, EEPROM_ENDURANCE);
+    }
+    printf("\n");
+}
+
+}
+
+int main(int argc, char **argv) {
+    Options o;
+    for (int i = 1; i < argc; i++) {
+        bool value = i + 1 < argc;
+        if (strcmp(argv[i], "--days") == 0 && value) {
+            o.days = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && value) {
+            o.seed = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--step") == 0 && value) {
+            o.step = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--loss") == 0 && value) {
+            o.loss = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--snr") == 0 && value) {
+            o.snr = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--snr-sigma") == 0 && value) {
+            o.snrSigma = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--corrupt") == 0 && value) {
+            o.corrupt = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--presses") == 0 && value) {
+            o.presses = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--spikes") == 0 && value) {
+            o.spikes = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--script") == 0 && value) {
+            o.script = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--days N] [--seed N] [--step MS] [--loss P] [--snr DB] [--snr-sigma DB]"
+                            " [--corrupt P] [--presses N] [--spikes P] [--script file]\n", argv[0]);
+            return 2;
+        }
+    }
+    uint64_t step = (uint64_t) (o.step * 1000);
+    if (step == 0) {
+        fprintf(stderr, "--step: expected a positive number of milliseconds\n");
+        return 2;
+    }
+
+    Model m(o.seed, Channel{o.loss, o.snr, o.snrSigma, o.corrupt});
+    m.spikes = o.spikes;
+    if (o.script) {
+        if (!loadScript(o.script, m)) {
+            return 2;
+        }
+    } else {
+        randomPresses(o, m);
+    }
+    m.start();
+
+    uint64_t end = (uint64_t) (o.days * DAY);
+    auto t0 = std::chrono::steady_clock::now();
+    m.run(end, step);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("simulated %.1f days in %.2f s, seed %u, loop() every %.1f ms, %s, frame airtime telemetry %.1f ms"
+           " command %.1f ms\n", o.days, elapsed, o.seed, o.step, RADIO.wakeInterval ? "CAD receive" : "continuous receive",
+           RADIO_AIRTIME_TELEMETRY / 1000.0, RADIO_AIRTIME_COMMAND / 1000.0);
+    printf("radio:\n");
+    printLink(m.remote);
+    printLink(m.home);
+    printf("commands: pressed %lu, servo moves %lu, no reaction %lu (%lu at the end), reboots %lu\n",
+           m.presses, m.servoMoves, m.unanswered, m.unansweredAtEnd, m.reboots);
+    m.servoLatency.print("command->servo", 1000, "ms");
+    m.ackLatency.print("command->ack at home", 1000, "ms");
+    m.bootToTelemetry.print("boot->first telemetry", 1000, "ms");
+    printf("telemetry freshness at home:\n");
+    m.freshness.print("age", 1e6, "s");
+    printf("  home screen: no signal %lu s, sensor error %lu s\n", m.noSignalSeconds, m.sensorErrorSeconds);
+    printf("heating:\n");
+    printf("  R1 cycles %lu, on %.1f%%; R2 cycles %lu, on %.1f%%\n", m.r1Cycles,
+           m.r1On * 100 * HOUR / end, m.r2Cycles, m.r2On * 100 * HOUR / end);
+    printf("  room %.1f..%.1f °C, DHT spikes %lu, max telemetry error %.2f °C\n",
+           m.roomMin, m.roomMax, m.dhtSpikes, m.filterError);
+    printf("eeprom:\n");
+    printEeprom(m.home, o.days);
+    printEeprom(m.remote, o.days);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef WINTERHOME_AUTHKEY_H
+#define WINTERHOME_AUTHKEY_H
+
+#include <stdint.h>
+
+// Ключ для модели: оба скетча в linksim собираются с аутентификацией кадров.
+const uint8_t AUTH_KEY[16] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+#endif //WINTERHOME_AUTHKEY_H
@@ -0,0 +1,25 @@
+#ifndef WINTERHOME_LINKSIM_SKETCHES_H
+#define WINTERHOME_LINKSIM_SKETCHES_H
+
+// Точки входа скетчей, собранных в linksim (home.cpp, remote.cpp).
+
+namespace home {
+
+void setup();
+
+void loop();
+
+}
+
+namespace remote {
+
+void setup(void);
+
+void loop(void);
+
+// Прерывание PCINT1 от энкодера уставки.
+void PCINT1_vect();
+
+}
+
+#endif //WINTERHOME_LINKSIM_SKETCHES_H
@@ -0,0 +1,32 @@
+// Скетч домашнего блока для linksim: home/src/main.cpp целиком в пространстве имен
+// home. Заголовки подключаются заранее, вне него, поэтому #include внутри скетча
+// ничего не добавляют, а библиотеки остаются общими для обоих блоков.
+
+#include <Arduino.h>
+
+#include <Button.h>
+#include <Task.h>
+#include <LoRa.h>
+#include <U8g2lib.h>
+#include <Format.h>
+#include <LowPowerRx.h>
+#include <Capture.h>
+#include <Frame.h>
+#include <Link.h>
+#include <RadioLink.h>
+#include <RemoteState.h>
+#include <Auth.h>
+#include <RadioProfile.h>
+#include <TxScheduler.h>
+#include <EEPROMex.h>
+#include <Fixed.h>
+#include <TrendBuffer.h>
+#include <AuthKey.h>
+
+#include "Sketches.h"
+
+namespace home {
+
+#include "../../home/src/main.cpp"
+
+}
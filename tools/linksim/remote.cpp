@@ -0,0 +1,34 @@
+// Скетч удаленного блока для linksim: remote/src/main.cpp целиком в пространстве
+// имен remote, заголовки подключаются заранее, как в home.cpp.
+
+#include <Arduino.h>
+
+#include <LoRa.h>
+#include <U8g2lib.h>
+#include <ServoEasing.h>
+#include <Format.h>
+#include <Wire.h>
+#include <dht_nonblocking.h>
+#include <Task.h>
+#include <AcceleratedEncoder.h>
+#include <EEPROMex.h>
+#include <Button.h>
+#include <LowPowerRx.h>
+#include <Frame.h>
+#include <Link.h>
+#include <RadioLink.h>
+#include <Auth.h>
+#include <RadioProfile.h>
+#include <TxScheduler.h>
+#include <Fixed.h>
+#include <SensorStats.h>
+#include <RemoteScreen.h>
+#include <AuthKey.h>
+
+#include "Sketches.h"
+
+namespace remote {
+
+#include "../../remote/src/main.cpp"
+
+}